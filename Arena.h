@@ -0,0 +1,355 @@
+// Arena.h
+// Many snakes on one board: the engine's stress scenario, with hundreds to thousands of
+// snakes (driven by the built-in arena AI, or by turns the caller supplies, e.g. from replay
+// logs) sharing one occupancy grid and a pool of food. Each tick runs in phases:
+//   1. every snake turns and works out the cell its head moves to        (parallel)
+//   2. the tails move off their cells                                     (in snake order)
+//   3. a head moving into a wall or any body dies                         (parallel)
+//   4. heads moving into the same cell all die (head-on); the claimed
+//      cells are sorted, so equal cells end up next to each other         (in snake order)
+//   5. the dead snakes' bodies are cleared, the others move in and eat    (in snake order)
+//   6. eaten food and (with respawn) dead snakes are placed anew          (in snake order)
+// The parallel phases only read the grid and write each snake's own slots, and everything
+// that changes the grid or draws from the arena's generator runs in snake order, so a tick's
+// outcome is the same for any number of threads. Like Snake::move(), a head may move into the
+// cell a tail (its own or another snake's) leaves in the same tick.
+#pragma once
+
+#include <algorithm>     // For std::sort
+#include <chrono>        // For the phase timings
+#include <cstdint>       // For the state hash
+#include <memory>        // For the layout
+#include <unordered_map> // For the food on large boards
+#include <utility>       // For std::pair
+#include <vector>        // For the per-snake arrays
+#include "SnakeCore.h"   // Snake, OccupancyGrid, LevelLayout, Rng
+#include "WorkStealingPool.h" // Parallel phases
+
+#define ARENA_CHUNK 256         // Snakes per parallel job
+#define ARENA_SPAWN_TRIES 64    // Random cells tried when placing a snake
+#define ARENA_BLOCKED -2        // foodDistance of a wall or body cell
+#define ARENA_HEAD -3           // foodDistance of a living snake's head
+
+// How a snake died
+enum ArenaFate { ARENA_MOVES = 0, ARENA_HIT_WALL, ARENA_HIT_BODY, ARENA_HEAD_ON };
+
+// --- Arena ---
+class Arena {
+public:
+    // Counters since the arena was built
+    struct Stats {
+        long long moves = 0;        // Snake moves made
+        long long eaten = 0;        // Food eaten
+        long long wallDeaths = 0, bodyDeaths = 0, headOnDeaths = 0;
+        long long respawns = 0;     // Dead snakes placed again
+        long long parallelNs = 0;   // Time in the parallel phases (1 and 3)
+        long long serialNs = 0;     // Time in the phases run in snake order (2, 4, 5 and 6)
+    };
+
+    std::shared_ptr<const LevelLayout> layout; // Walls of the board
+    OccupancyGrid grid;         // Walls, every snake's body and the food
+    std::vector<Snake> snakes;  // Snake i (a dead one keeps its last body until it respawns)
+    std::vector<char> alive;    // 1 while snake i is on the board
+    std::vector<int> fruits;    // Food snake i has eaten, over all its lives
+    std::vector<Rng> choices;   // Snake i's own generator, for the arena AI's tie-breaks
+    std::vector<Point> food;    // Food items (kept at a fixed count while there is room)
+    Rng rng;                    // Places food and snakes
+    bool respawn = true;        // Dead snakes come back on a free spot at the end of the tick
+    long long ticks = 0;
+    Stats stats;
+
+    // Places snakeCount snakes of length 3 (heading right) and foodCount food items on
+    // random free cells of the layout. Snakes that find no room start dead.
+    Arena(std::shared_ptr<const LevelLayout> levelLayout, int snakeCount, int foodCount, uint64_t seed)
+        : layout(levelLayout), grid(*levelLayout), alive(snakeCount, 0), fruits(snakeCount, 0), rng(seed),
+          next(snakeCount), fate(snakeCount, ARENA_MOVES) {
+        Rng seeds(seed ^ 0x9E3779B97F4A7C15ULL);
+        snakes.reserve(snakeCount);
+        for (int i = 0; i < snakeCount; i++) {
+            snakes.emplace_back(0, 0, 1);
+            choices.emplace_back(seeds.next64());
+            spawnSnake(i);
+        }
+        for (int f = 0; f < foodCount; f++) {
+            Point p;
+            if (!grid.randomEmptyCell(rng, p)) break;
+            grid.set(p, CELL_FOOD);
+            foodAt[key(p)] = (int)food.size();
+            food.push_back(p);
+        }
+    }
+
+    int size() const { return (int)snakes.size(); }
+
+    // Snakes on the board
+    int aliveCount() const {
+        int n = 0;
+        for (char a : alive) n += a;
+        return n;
+    }
+
+    // The arena AI: each living snake heads for its nearest reachable food item. One
+    // breadth-first search from all the food at once (measureFoodDistance) gives every free
+    // cell its distance to the nearest food through free cells. A snake takes the move into
+    // the free cell closest to food, preferring a cell no other head is next to (so no other
+    // snake can move there too) and then one food can be reached from, with ties broken at
+    // random; with no free cell it goes straight on. Writes one turn per snake (DIR_NONE for
+    // straight on and for dead snakes). The search runs on this thread, the moves on the pool
+    // when one is given.
+    void chooseTurns(char* turns, WorkStealingPool* pool = nullptr) {
+        measureFoodDistance();
+        forEach(pool, [&](int i) {
+            turns[i] = DIR_NONE;
+            if (!alive[i]) return;
+            static const char dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+            static const char reverse[4] = {DIR_DOWN, DIR_UP, DIR_RIGHT, DIR_LEFT};
+            static const int dx[4] = {0, 0, -1, 1}, dy[4] = {-1, 1, 0, 0};
+            const Snake& s = snakes[i];
+            const int step[4] = {-(grid.width + 2), grid.width + 2, -1, 1}; // dx, dy in the padded field
+            long long cells = (long long)grid.width * grid.height;
+            long long head = paddedKey(s.head());
+            long long best = -1;
+            int ties = 0;
+            for (int d = 0; d < 4; d++) {
+                if (reverse[d] == s.direction) continue;
+                Point p(s.head().x + dx[d], s.head().y + dy[d]);
+                unsigned char cell = grid.get(p);
+                if (cell != CELL_EMPTY && cell != CELL_FOOD) continue;
+                long long c = head + step[d];
+                long long distance = foodDistance[c];
+                if (distance < 0) distance = cells; // Cut off from all food
+                for (int e = 0; e < 4; e++) { // Another head next to the cell could take it too
+                    if (c + step[e] != head && foodDistance[c + step[e]] == ARENA_HEAD) {
+                        distance += 2 * cells;
+                        break;
+                    }
+                }
+                if (best < 0 || distance < best) {
+                    best = distance;
+                    turns[i] = dirs[d];
+                    ties = 1;
+                } else if (distance == best && choices[i].below(++ties) == 0) {
+                    turns[i] = dirs[d];
+                }
+            }
+            if (turns[i] == s.direction) turns[i] = DIR_NONE;
+        });
+    }
+
+    // Advances every snake by one tick; turns holds one turn per snake (DIR_NONE, or nullptr
+    // for all straight on). Returns the number of snakes that died.
+    int step(const char* turns, WorkStealingPool* pool = nullptr) {
+        auto t0 = std::chrono::steady_clock::now();
+        // 1. Turn, and find where each head goes
+        forEach(pool, [&](int i) {
+            fate[i] = ARENA_MOVES;
+            if (!alive[i]) return;
+            if (turns && turns[i] != DIR_NONE) snakes[i].changeDirection(turns[i]);
+            next[i] = snakes[i].nextHead();
+        });
+        auto t1 = std::chrono::steady_clock::now();
+        // 2. Tails leave their cells (the grid's free cell index is shared, so one at a time)
+        for (int i = 0; i < size(); i++)
+            if (alive[i]) snakes[i].releaseTail(grid);
+        auto t2 = std::chrono::steady_clock::now();
+        // 3. Walls and bodies, on the grid as it is after the tails moved
+        forEach(pool, [&](int i) {
+            if (!alive[i]) return;
+            unsigned char cell = grid.get(next[i]);
+            if (cell == CELL_WALL) fate[i] = ARENA_HIT_WALL;
+            else if (cell == CELL_SNAKE) fate[i] = ARENA_HIT_BODY;
+        });
+        auto t3 = std::chrono::steady_clock::now();
+        // 4. Head-on: the cells claimed by more than one head
+        claims.clear();
+        for (int i = 0; i < size(); i++)
+            if (alive[i] && fate[i] == ARENA_MOVES) claims.push_back({key(next[i]), i});
+        std::sort(claims.begin(), claims.end());
+        for (size_t a = 0, b; a < claims.size(); a = b) {
+            for (b = a + 1; b < claims.size() && claims[b].first == claims[a].first; b++) {}
+            if (b - a > 1)
+                for (size_t c = a; c < b; c++) fate[claims[c].second] = ARENA_HEAD_ON;
+        }
+        // 5. The dead leave the board, the others move in
+        int deaths = 0;
+        eaten.clear();
+        for (int i = 0; i < size(); i++) {
+            if (!alive[i]) continue;
+            if (fate[i] != ARENA_MOVES) {
+                kill(i);
+                deaths++;
+                continue;
+            }
+            stats.moves++;
+            if (snakes[i].enter(next[i], grid)) {
+                fruits[i]++;
+                eaten.push_back(next[i]);
+            }
+        }
+        // 6. New food for the eaten, new lives for the dead
+        for (const Point& p : eaten) replaceFood(p);
+        stats.eaten += (long long)eaten.size();
+        if (respawn) {
+            for (int i = 0; i < size(); i++)
+                if (!alive[i] && spawnSnake(i)) stats.respawns++;
+        }
+        auto t4 = std::chrono::steady_clock::now();
+        stats.parallelNs += std::chrono::duration_cast<std::chrono::nanoseconds>((t1 - t0) + (t3 - t2)).count();
+        stats.serialNs += std::chrono::duration_cast<std::chrono::nanoseconds>((t2 - t1) + (t4 - t3)).count();
+        ticks++;
+        return deaths;
+    }
+
+    // Length of the longest living snake
+    int longest() const {
+        int n = 0;
+        for (int i = 0; i < size(); i++)
+            if (alive[i] && snakes[i].length > n) n = snakes[i].length;
+        return n;
+    }
+
+    // FNV-1a over every living snake's body and direction, the food and the fruit counts;
+    // equal for equal states, whatever the number of threads that produced them
+    uint64_t hash() const {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](uint64_t v) {
+            for (int i = 0; i < 8; i++) {
+                h ^= (v >> (i * 8)) & 0xFF;
+                h *= 1099511628211ULL;
+            }
+        };
+        for (int i = 0; i < size(); i++) {
+            mix(alive[i]);
+            mix((uint64_t)fruits[i]);
+            if (!alive[i]) continue;
+            mix(snakes[i].direction);
+            mix(snakes[i].length);
+            for (int k = 0; k < snakes[i].length; k++) {
+                mix((uint32_t)snakes[i].segment(k).x);
+                mix((uint32_t)snakes[i].segment(k).y);
+            }
+        }
+        for (const Point& p : food) {
+            mix((uint32_t)p.x);
+            mix((uint32_t)p.y);
+        }
+        return h;
+    }
+
+private:
+    std::vector<Point> next;                    // Cell each head moves to this tick
+    std::vector<char> fate;                     // ArenaFate of each snake this tick
+    std::vector<std::pair<long long, int>> claims; // (cell, snake) for the head-on check
+    std::vector<Point> eaten;                   // Food eaten this tick
+    std::unordered_map<long long, int> foodAt;  // Food item on each food cell
+    // The food distance field has a border of ARENA_BLOCKED cells round the board, so its
+    // searches need no bounds checks; it is indexed by paddedKey()
+    std::vector<int> openDistance;              // Field of the bare layout: -1, or ARENA_BLOCKED on walls
+    std::vector<int> foodDistance;              // Steps from each free cell to the nearest food (-1 if none),
+                                                // ARENA_BLOCKED or ARENA_HEAD elsewhere
+    std::vector<int> frontier;                  // Queue of the food distance search
+
+    long long key(const Point& p) const { return (long long)p.y * grid.width + p.x; }
+    long long paddedKey(const Point& p) const { return (long long)(p.y + 1) * (grid.width + 2) + p.x + 1; }
+
+    // Runs f(i) for every snake, in ARENA_CHUNK slices on the pool when there is one
+    template <typename F>
+    void forEach(WorkStealingPool* pool, const F& f) {
+        int n = size();
+        if (!pool || pool->size() < 2 || n <= ARENA_CHUNK) {
+            for (int i = 0; i < n; i++) f(i);
+            return;
+        }
+        for (int begin = 0; begin < n; begin += ARENA_CHUNK) {
+            int end = std::min(n, begin + ARENA_CHUNK);
+            pool->submit([&f, begin, end](int) {
+                for (int i = begin; i < end; i++) f(i);
+            });
+        }
+        pool->wait();
+    }
+
+    // Fills foodDistance by a breadth-first search from every food cell at once over the free
+    // cells, as the board is before this tick's moves. The walls come from the layout and the
+    // bodies from the snakes, so the search never reads the (possibly chunked) grid.
+    void measureFoodDistance() {
+        int w = grid.width, h = grid.height, pw = w + 2;
+        if (openDistance.empty()) {
+            openDistance.assign((size_t)pw * (h + 2), ARENA_BLOCKED);
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    if (layout->cells[(size_t)y * w + x] != CELL_WALL) openDistance[paddedKey(Point(x, y))] = -1;
+        }
+        foodDistance = openDistance;
+        for (int i = 0; i < size(); i++) {
+            if (!alive[i]) continue;
+            const Snake& s = snakes[i];
+            for (int k = 1; k < s.length; k++) foodDistance[paddedKey(s.segment(k))] = ARENA_BLOCKED; // Arena bodies are all on the board
+            foodDistance[paddedKey(s.head())] = ARENA_HEAD;
+        }
+        frontier.clear();
+        for (const Point& p : food) {
+            foodDistance[paddedKey(p)] = 0;
+            frontier.push_back((int)paddedKey(p));
+        }
+        const int step[4] = {-pw, pw, -1, 1};
+        frontier.resize(foodDistance.size()); // Every cell enters the queue at most once
+        size_t head = 0, tail = food.size();
+        int* field = foodDistance.data();
+        while (head < tail) {
+            int c = frontier[head++], next = field[c] + 1;
+            for (int d = 0; d < 4; d++) {
+                int n = c + step[d];
+                if (field[n] != -1) continue; // Reached already, or not free
+                field[n] = next;
+                frontier[tail++] = n;
+            }
+        }
+    }
+
+    // Takes a snake off the board, counting how it died
+    void kill(int i) {
+        const Snake& s = snakes[i];
+        for (int k = 0; k < s.length; k++)
+            if (grid.get(s.segment(k)) == CELL_SNAKE) grid.set(s.segment(k), CELL_EMPTY);
+        alive[i] = 0;
+        if (fate[i] == ARENA_HIT_WALL) stats.wallDeaths++;
+        else if (fate[i] == ARENA_HIT_BODY) stats.bodyDeaths++;
+        else stats.headOnDeaths++;
+    }
+
+    // Puts snake i on a random free row of four cells (its three segments and the cell ahead);
+    // returns false if none was found
+    bool spawnSnake(int i) {
+        for (int attempt = 0; attempt < ARENA_SPAWN_TRIES; attempt++) {
+            Point p;
+            if (!grid.randomEmptyCell(rng, p)) return false;
+            if (grid.get(p.x - 1, p.y) != CELL_EMPTY || grid.get(p.x - 2, p.y) != CELL_EMPTY ||
+                grid.get(p.x + 1, p.y) != CELL_EMPTY)
+                continue;
+            snakes[i] = Snake(p.x, p.y, 1);
+            snakes[i].place(grid);
+            alive[i] = 1;
+            return true;
+        }
+        return false;
+    }
+
+    // Moves an eaten food item to a random free cell (it is gone if the board is full)
+    void replaceFood(const Point& eatenAt) {
+        auto it = foodAt.find(key(eatenAt));
+        if (it == foodAt.end()) return;
+        int f = it->second;
+        foodAt.erase(it);
+        Point p;
+        if (!grid.randomEmptyCell(rng, p)) {
+            food[f] = food.back(); // Drop the item, keeping the list dense
+            if (f < (int)food.size() - 1) foodAt[key(food[f])] = f;
+            food.pop_back();
+            return;
+        }
+        grid.set(p, CELL_FOOD);
+        food[f] = p;
+        foodAt[key(p)] = f;
+    }
+};
@@ -0,0 +1,493 @@
+// Autopilot.h
+// Built-in AI player. A strategy looks at a Board and picks a direction each tick; the
+// Autopilot turns that into an InputCommand on its own CommandQueue, so its turns take the
+// same path through the turn buffer as key presses. Used to load-test the engine and to
+// check that every level can be cleared.
+//
+// Strategies:
+//   bfs / astar - shortest path to the food (breadth-first or A*), taken only if the snake
+//                 could still reach its own tail after eating; otherwise the Hamiltonian
+//                 cycle is followed if the head is on it, otherwise the move that keeps the
+//                 tail reachable with the most room
+//   cycle       - follows a Hamiltonian cycle through the level's free 2x2 blocks; food
+//                 off the cycle (next to a wall) is fetched by shortest path when the tail
+//                 stays reachable, then the snake heads back to the nearest cycle cell.
+//                 A snake that goes CYCLE_STALL_FACTOR ticks per board cell without eating
+//                 plays bfs until it eats again, and after twice that long takes the
+//                 shortest path to the food even if it cannot get out again (food in a
+//                 dead-end cell), so the game ends instead of circling until the tick cap.
+//
+// The planner works on dense copies of the grid, so it plays standard-size boards only
+// (see autopilotSupports()).
+#pragma once
+
+#include <algorithm>   // For std::reverse and the A* heap
+#include <chrono>      // For timing each plan
+#include <cstdlib>     // For abs()
+#include <functional>  // For std::greater
+#include <memory>      // For std::unique_ptr
+#include <string>      // For strategy names
+#include <utility>     // For std::pair
+#include <vector>      // For search scratch space
+#include "SnakeCore.h" // For Board, Snake and the cell types
+#include "InputQueue.h" // For InputCommand and CommandQueue
+
+#define CYCLE_STALL_FACTOR 2 // Ticks per board cell without food before the cycle player gives up on the cycle
+
+// Directions in a fixed order with their head offsets
+const char AUTOPILOT_DIRS[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+const int AUTOPILOT_DX[4] = {0, 0, -1, 1};
+const int AUTOPILOT_DY[4] = {-1, 1, 0, 0};
+
+// True if the snake's head may enter a cell of this type
+inline bool isPassable(unsigned char cell) { return cell == CELL_EMPTY || cell == CELL_FOOD; }
+
+// --- Path Planner ---
+// Path searches over a copy of a board's cells (reachability questions use the bitboard
+// kernels instead). Scratch arrays, the A* heap included, are reused between calls and
+// "visited" is tracked with a generation stamp, so once the arrays have grown to the board a
+// search allocates nothing.
+class PathPlanner {
+public:
+    int width = 0, height = 0;
+    std::vector<unsigned char> cells; // Working copy of the occupancy grid
+    std::vector<unsigned> seen;       // Generation in which a cell was reached
+    std::vector<int> parent;          // Predecessor of each reached cell
+    std::vector<int> dist;            // Steps from the search start
+    std::vector<int> open;            // BFS queue
+    std::vector<std::pair<int, int>> frontier; // A* open list as a min-heap of (f = g + h, cell)
+    unsigned generation = 0;
+
+    // Loads the board's current occupancy
+    void load(const Board& board) {
+        width = board.grid.width;
+        height = board.grid.height;
+        cells = board.grid.cells;
+        if ((int)seen.size() != width * height) {
+            seen.assign(width * height, 0);
+            parent.assign(width * height, -1);
+            dist.assign(width * height, 0);
+            open.resize(width * height);
+            generation = 0;
+        }
+    }
+
+    // Starts a new search generation (wrapping the counter clears the stamps)
+    void nextGeneration() {
+        if (++generation == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            generation = 1;
+        }
+    }
+
+    // Breadth-first search from start. Stops early at goal if goal >= 0 (goal is always
+    // enterable). Returns the number of cells reached.
+    int bfs(int start, int goal) {
+        nextGeneration();
+        int head = 0, tail = 0, reached = 1;
+        open[tail++] = start;
+        seen[start] = generation;
+        dist[start] = 0;
+        parent[start] = -1;
+        while (head < tail) {
+            int c = open[head++];
+            if (c == goal) return reached;
+            int x = c % width, y = c / width;
+            for (int d = 0; d < 4; d++) {
+                int nx = x + AUTOPILOT_DX[d], ny = y + AUTOPILOT_DY[d];
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+                int n = ny * width + nx;
+                if (seen[n] == generation || (n != goal && !isPassable(cells[n]))) continue;
+                seen[n] = generation;
+                dist[n] = dist[c] + 1;
+                parent[n] = c;
+                open[tail++] = n;
+                reached++;
+            }
+        }
+        return reached;
+    }
+
+    // A* from start to goal with the Manhattan distance as heuristic. Returns true if found.
+    bool astar(int start, int goal) {
+        nextGeneration();
+        typedef std::pair<int, int> Entry;
+        std::greater<Entry> later; // Heap order: smallest f on top
+        frontier.clear();
+        int gx = goal % width, gy = goal / width;
+        seen[start] = generation;
+        dist[start] = 0;
+        parent[start] = -1;
+        frontier.push_back({abs(start % width - gx) + abs(start / width - gy), start});
+        while (!frontier.empty()) {
+            std::pop_heap(frontier.begin(), frontier.end(), later);
+            Entry e = frontier.back();
+            frontier.pop_back();
+            int c = e.second;
+            if (c == goal) return true;
+            int x = c % width, y = c / width;
+            if (e.first > dist[c] + abs(x - gx) + abs(y - gy)) continue; // Stale entry
+            for (int d = 0; d < 4; d++) {
+                int nx = x + AUTOPILOT_DX[d], ny = y + AUTOPILOT_DY[d];
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+                int n = ny * width + nx;
+                if (n != goal && !isPassable(cells[n])) continue;
+                if (seen[n] == generation && dist[n] <= dist[c] + 1) continue;
+                seen[n] = generation;
+                dist[n] = dist[c] + 1;
+                parent[n] = c;
+                frontier.push_back({dist[n] + abs(nx - gx) + abs(ny - gy), n});
+                std::push_heap(frontier.begin(), frontier.end(), later);
+            }
+        }
+        return false;
+    }
+
+    // Rebuilds the path found by the last search, excluding start, ending at goal
+    void tracePath(int goal, std::vector<int>& path) const {
+        path.clear();
+        for (int c = goal; parent[c] >= 0; c = parent[c]) path.push_back(c);
+        std::reverse(path.begin(), path.end());
+    }
+};
+
+// Cell of the snake's tail after it follows path (-1 if the tail is still off the board)
+inline int tailAfterPath(const Snake& snake, const std::vector<int>& path, const OccupancyGrid& grid) {
+    int steps = (int)path.size();
+    int freed = steps - snake.pendingGrowth; // Tail segments released along the way
+    if (freed < 0) freed = 0;
+    // Virtual body, newest first: path reversed, then the old segments
+    int tailPos = snake.length + (steps - freed) - 1;
+    if (tailPos < steps) return path[steps - 1 - tailPos];
+    const Point& tail = snake.segment(tailPos - steps);
+    return grid.get(tail) == CELL_SNAKE ? tail.y * grid.width + tail.x : -1;
+}
+
+// --- Hamiltonian Cycle ---
+// A cycle through every cell of the free 2x2 blocks of a level, built by walking around a
+// spanning tree of those blocks. Blocks that touch a wall are left out, so the cycle fits
+// the level 2-6 mazes; cells outside it have next == -1.
+class HamiltonianCycle {
+public:
+    int width = 0, height = 0, level = 0; // Board the cycle was built for
+    std::vector<int> next;                // Successor of each cell on the cycle, or -1
+    int length = 0;                       // Cells on the cycle
+
+    // Builds the cycle for the board's walls (only the first time for each level)
+    void build(const Board& board) {
+        const OccupancyGrid& grid = board.grid;
+        if (level == board.level && width == grid.width && height == grid.height) return;
+        width = grid.width;
+        height = grid.height;
+        level = board.level;
+        next.assign(width * height, -1);
+        length = 0;
+
+        int bw = (width - 2) / 2, bh = (height - 2) / 2; // Blocks cover the interior from (1, 1)
+        if (bw <= 0 || bh <= 0) return;
+        std::vector<char> freeBlock(bw * bh, 0);
+        for (int by = 0; by < bh; by++)
+            for (int bx = 0; bx < bw; bx++) {
+                bool ok = true;
+                for (int k = 0; k < 4 && ok; k++)
+                    ok = grid.get(1 + 2 * bx + (k & 1), 1 + 2 * by + (k >> 1)) != CELL_WALL;
+                freeBlock[by * bw + bx] = ok;
+            }
+
+        // Spanning tree by BFS from the first free block; blocks it cannot reach stay off the cycle
+        int root = -1;
+        for (int b = 0; b < bw * bh && root < 0; b++)
+            if (freeBlock[b]) root = b;
+        if (root < 0) return;
+        // link[b] bit d set if the tree connects block b to its neighbour in direction d
+        std::vector<unsigned char> link(bw * bh, 0), inTree(bw * bh, 0);
+        std::vector<int> queue;
+        queue.push_back(root);
+        inTree[root] = 1;
+        for (size_t i = 0; i < queue.size(); i++) {
+            int b = queue[i], bx = b % bw, by = b / bw;
+            for (int d = 0; d < 4; d++) {
+                int nx = bx + AUTOPILOT_DX[d], ny = by + AUTOPILOT_DY[d];
+                if (nx < 0 || nx >= bw || ny < 0 || ny >= bh) continue;
+                int n = ny * bw + nx;
+                if (!freeBlock[n] || inTree[n]) continue;
+                inTree[n] = 1;
+                link[b] |= 1 << d;
+                link[n] |= 1 << (d ^ 1); // UP<->DOWN, LEFT<->RIGHT
+                queue.push_back(n);
+            }
+        }
+
+        // Each block is circled counter-clockwise (down the left side, right along the
+        // bottom, up the right side, left along the top); a tree edge replaces the step
+        // along the shared side with a step across it, splicing the two loops together.
+        for (int b : queue) {
+            int x0 = 1 + 2 * (b % bw), y0 = 1 + 2 * (b / bw);
+            int tl = y0 * width + x0, tr = tl + 1, bl = tl + width, br = bl + 1;
+            next[tl] = (link[b] & (1 << 2)) ? tl - 1 : bl;          // Left side
+            next[bl] = (link[b] & (1 << 1)) ? bl + width : br;      // Bottom side
+            next[br] = (link[b] & (1 << 3)) ? br + 1 : tr;          // Right side
+            next[tr] = (link[b] & (1 << 0)) ? tr - width : tl;      // Top side
+            length += 4;
+        }
+    }
+};
+
+// --- Strategies ---
+class AutopilotStrategy {
+public:
+    virtual ~AutopilotStrategy() {}
+    virtual const char* name() const = 0;
+    // Returns the direction to move this tick (DIR_NONE keeps the current direction)
+    virtual char chooseDirection(const Board& board) = 0;
+};
+
+// Direction that moves the head from cell a to the neighbouring cell b
+inline char directionBetween(int a, int b, int width) {
+    if (b == a - width) return DIR_UP;
+    if (b == a + width) return DIR_DOWN;
+    if (b == a - 1) return DIR_LEFT;
+    return DIR_RIGHT;
+}
+
+// Shared safety checks and the survival fallback
+class SafeMoveStrategy : public AutopilotStrategy {
+protected:
+    PathPlanner planner;
+    HamiltonianCycle cycle;
+    std::vector<int> path;
+    std::vector<int> step;             // One-move route, refilled by oneStep()
+    Bitboard open, seed, reach, timed; // Scratch for the bitboard reachability checks
+
+    // The route of a single move to cell, in the reused step buffer
+    const std::vector<int>& oneStep(int cell) {
+        step.assign(1, cell);
+        return step;
+    }
+
+    // Flood-fills from the head's cell at the end of route over the board as it will be then
+    // (tail segments released, route occupied), leaving the result in reach. Returns the
+    // tail's cell at that point, or -1 if the tail is still off the board.
+    int reachAfter(const Board& board, const std::vector<int>& route) {
+        const Snake& snake = *board.snake;
+        const OccupancyGrid& grid = board.grid;
+        int w = grid.width;
+        if (open.width != w || open.height != grid.height) {
+            open.resize(w, grid.height);
+            seed.resize(w, grid.height);
+        }
+        grid.passable(open);
+        int freed = (int)route.size() - snake.pendingGrowth;
+        for (int i = 0; i < freed && i < snake.length; i++) {
+            const Point& p = snake.segment(snake.length - 1 - i);
+            if (grid.get(p) == CELL_SNAKE) open.set(p.x, p.y);
+        }
+        for (int c : route) open.reset(c % w, c / w);
+        int tail = tailAfterPath(snake, route, grid);
+        if (tail >= 0) open.set(tail % w, tail / w); // The tail moves on, so its cell counts as open
+        seed.clear();
+        seed.set(route.back() % w, route.back() / w);
+        floodFill(seed, open, reach);
+        return tail;
+    }
+
+    // True if after following route the snake's head can still reach its tail
+    bool tailReachableAfter(const Board& board, const std::vector<int>& route) {
+        int tail = reachAfter(board, route);
+        if (tail < 0) return true; // Tail still off the board: it will come on behind the head
+        return reach.test(tail % board.grid.width, tail / board.grid.width);
+    }
+
+    // Picks the move that keeps the tail reachable with the most room. When no move does
+    // (the tail is cut off by the body as it is now), prefers a move from which the head can
+    // still get to the tail's cell through body cells that free up in time
+    // (Board::reachableBeforeTailFrees); failing that, just the most room.
+    char survivalMove(const Board& board) {
+        const Snake& snake = *board.snake;
+        const Point& tail = snake.tail();
+        bool tailOnBoard = board.grid.get(tail) == CELL_SNAKE;
+        int w = board.grid.width;
+        int moves = board.safeMoves();
+        char best = DIR_NONE;
+        long bestScore = -1;
+        for (int d = 0; d < 4; d++) {
+            if (!(moves & (1 << d))) continue;
+            Point n(snake.head().x + AUTOPILOT_DX[d], snake.head().y + AUTOPILOT_DY[d]);
+            int after = reachAfter(board, oneStep(n.y * w + n.x));
+            int room = reach.count();
+            long score = room;
+            if (after < 0 || reach.test(after % w, after / w)) {
+                score += 2000000L;
+            } else {
+                board.reachableBeforeTailFrees(timed, AUTOPILOT_DIRS[d]);
+                if (!tailOnBoard || timed.test(tail.x, tail.y)) score += 1000000L;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                best = AUTOPILOT_DIRS[d];
+            }
+        }
+        return best;
+    }
+
+    // Follows the Hamiltonian cycle if the head is on it and the next cell is safe
+    char cycleMove(const Board& board) {
+        cycle.build(board);
+        const Snake& snake = *board.snake;
+        int w = board.grid.width;
+        int head = snake.head().y * w + snake.head().x;
+        int n = cycle.next[head];
+        if (n < 0) return DIR_NONE;
+        char dir = directionBetween(head, n, w);
+        int bit = dir == DIR_UP ? 1 : dir == DIR_DOWN ? 2 : dir == DIR_LEFT ? 4 : 8; // As in safeMoves()
+        return (board.safeMoves() & bit) ? dir : DIR_NONE;
+    }
+};
+
+// Shortest path to the food with a tail-reachability check
+class FoodPathStrategy : public SafeMoveStrategy {
+public:
+    bool useAStar; // A* instead of breadth-first search
+
+    FoodPathStrategy(bool useAStar) : useAStar(useAStar) {}
+    const char* name() const { return useAStar ? "astar" : "bfs"; }
+
+    char chooseDirection(const Board& board) {
+        if (board.hasFood) {
+            const Snake& snake = *board.snake;
+            int w = board.grid.width;
+            int head = snake.head().y * w + snake.head().x;
+            int food = board.food.y * w + board.food.x;
+            planner.load(board);
+            bool found = useAStar ? planner.astar(head, food)
+                                  : (planner.bfs(head, food), planner.seen[food] == planner.generation);
+            if (found) {
+                planner.tracePath(food, path);
+                if (!path.empty() && tailReachableAfter(board, path)) return directionBetween(head, path[0], w);
+            }
+        }
+        // No safe path to the food: stay on the cycle if that keeps the tail in reach
+        char dir = cycleMove(board);
+        if (dir != DIR_NONE) {
+            const Point& h = board.snake->head();
+            if (tailReachableAfter(board, oneStep(cycle.next[h.y * board.grid.width + h.x]))) return dir;
+        }
+        return survivalMove(board);
+    }
+};
+
+// Hamiltonian cycle following, with detours for food the cycle does not pass
+class CycleStrategy : public SafeMoveStrategy {
+public:
+    const char* name() const { return "cycle"; }
+
+    char chooseDirection(const Board& board) {
+        // Stall detector: count the ticks since the board last changed its fruit count
+        if (board.level != lastLevel || board.fruitCount != lastFruits) {
+            lastLevel = board.level;
+            lastFruits = board.fruitCount;
+            sinceFruit = 0;
+        }
+        sinceFruit++;
+        const Snake& snake = *board.snake;
+        int w = board.grid.width;
+        int head = snake.head().y * w + snake.head().x;
+        long long stallTicks = (long long)CYCLE_STALL_FACTOR * w * board.grid.height;
+        if (sinceFruit > 2 * stallTicks && board.hasFood) {
+            // Still stalled under bfs: the food can only be eaten at the cost of the snake
+            int food = board.food.y * w + board.food.x;
+            planner.load(board);
+            planner.bfs(head, food);
+            if (planner.seen[food] == planner.generation) {
+                planner.tracePath(food, path);
+                if (!path.empty()) return directionBetween(head, path[0], w);
+            }
+        }
+        if (sinceFruit > stallTicks) {
+            return fallback.chooseDirection(board);
+        }
+
+        cycle.build(board);
+        if (board.hasFood && cycle.next[board.food.y * w + board.food.x] < 0) {
+            // Food off the cycle: fetch it if the tail stays reachable afterwards
+            int food = board.food.y * w + board.food.x;
+            planner.load(board);
+            planner.bfs(head, food);
+            if (planner.seen[food] == planner.generation) {
+                planner.tracePath(food, path);
+                if (!path.empty() && tailReachableAfter(board, path)) return directionBetween(head, path[0], w);
+            }
+        }
+        if (cycle.next[head] < 0) {
+            // Off the cycle (after a detour, or at the start): head for the nearest cycle cell
+            planner.load(board);
+            int reached = planner.bfs(head, -1);
+            for (int i = 1; i < reached; i++) {
+                int c = planner.open[i];
+                if (cycle.next[c] < 0) continue;
+                planner.tracePath(c, path);
+                if (tailReachableAfter(board, path)) return directionBetween(head, path[0], w);
+                break;
+            }
+            return survivalMove(board);
+        }
+        char dir = cycleMove(board);
+        if (dir != DIR_NONE) {
+            if (tailReachableAfter(board, oneStep(cycle.next[head]))) return dir;
+        }
+        return survivalMove(board);
+    }
+
+private:
+    FoodPathStrategy fallback{false}; // Plays while stalled
+    int lastLevel = 0, lastFruits = -1;
+    long long sinceFruit = 0;          // Ticks since the fruit count last changed
+};
+
+// True if the autopilot can play boards of this size (not the chunked large boards)
+inline bool autopilotSupports(const GameConfig& config) {
+    return (long long)config.width * config.height <= CHUNKED_BOARD_CELLS;
+}
+
+// Creates a strategy by name ("bfs", "astar" or "cycle"); returns nullptr for unknown names
+inline std::unique_ptr<AutopilotStrategy> makeAutopilotStrategy(const std::string& name) {
+    if (name == "bfs") return std::unique_ptr<AutopilotStrategy>(new FoodPathStrategy(false));
+    if (name == "astar") return std::unique_ptr<AutopilotStrategy>(new FoodPathStrategy(true));
+    if (name == "cycle") return std::unique_ptr<AutopilotStrategy>(new CycleStrategy());
+    return nullptr;
+}
+
+// --- Autopilot Class ---
+// Plans one move per tick with a strategy, times every plan, and issues the result as a
+// turn command on its own queue (one producer per SPSC queue).
+class Autopilot {
+public:
+    std::unique_ptr<AutopilotStrategy> strategy;
+    CommandQueue commands;     // Turns issued by the autopilot, drained like keyboard input
+    long long plans = 0;       // Plans made
+    long long totalPlanNs = 0; // Time spent planning
+    long long maxPlanNs = 0;   // Slowest plan
+
+    Autopilot(std::unique_ptr<AutopilotStrategy> strategy) : strategy(std::move(strategy)) {}
+
+    // Plans the move for this tick and queues it as a turn (nothing is queued for "straight on")
+    void issue(const Board& board) {
+        auto begin = std::chrono::steady_clock::now();
+        char dir = strategy->chooseDirection(board);
+        auto end = std::chrono::steady_clock::now();
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        plans++;
+        totalPlanNs += ns;
+        if (ns > maxPlanNs) maxPlanNs = ns;
+
+        if (dir == DIR_NONE || dir == board.snake->direction) return;
+        InputCommand cmd;
+        cmd.type = CMD_TURN;
+        cmd.direction = dir;
+        cmd.timestamp = end;
+        commands.tryPush(cmd);
+    }
+
+    double averagePlanUs() const { return plans ? totalPlanNs / 1000.0 / plans : 0.0; }
+    double maxPlanUs() const { return maxPlanNs / 1000.0; }
+};
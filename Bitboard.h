@@ -0,0 +1,240 @@
+// Bitboard.h
+// One bit per board cell, for whole-board questions that the per-cell occupancy grid answers
+// slowly: "which cells can the head reach", "which cells can it reach before the tail frees
+// them", "which cells are blocked". A 70x30 board is 60 words; the kernels below work on
+// whole words (or four at a time with AVX2) instead of visiting cells one by one.
+//
+// Layout: each row starts on a word boundary and has wordsPerRow = ceil((width + 1) / 64)
+// words, so every row ends in at least one padding bit that is always zero. Because of that
+// bit, shifting the whole array left or right by one moves cells east or west without any
+// per-row masking: nothing carries from the end of one row into the start of the next.
+// Zeroed guard words before and after the rows make north/south shifts plain offset loads.
+#pragma once
+
+#include <algorithm> // For std::fill
+#include <cstdint>   // For uint64_t
+#include <utility>   // For std::swap
+#include <vector>    // For the word storage
+#ifdef __AVX2__
+#include <immintrin.h> // For the 256-bit dilation kernel
+#endif
+
+class Bitboard {
+public:
+    int width = 0, height = 0; // Board size in cells
+    int wordsPerRow = 0;       // 64-bit words per row, including the padding bit
+    int words = 0;             // height * wordsPerRow
+    int guard = 0;             // Zero words kept before and after the rows
+    std::vector<uint64_t> storage;
+
+    Bitboard() {}
+    Bitboard(int width, int height) { resize(width, height); }
+
+    // Sets the board size and clears every bit
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        wordsPerRow = (w + 1 + 63) / 64;
+        words = h * wordsPerRow;
+        guard = (wordsPerRow + 3) / 4 * 4 + 4; // Covers a one-row shift plus a partial AVX2 block
+        storage.assign(guard + words + guard, 0);
+    }
+
+    uint64_t* data() { return storage.data() + guard; }
+    const uint64_t* data() const { return storage.data() + guard; }
+
+    bool test(int x, int y) const {
+        return (data()[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    void set(int x, int y) { data()[y * wordsPerRow + (x >> 6)] |= 1ULL << (x & 63); }
+    void reset(int x, int y) { data()[y * wordsPerRow + (x >> 6)] &= ~(1ULL << (x & 63)); }
+
+    void clear() { std::fill(storage.begin(), storage.end(), 0); }
+
+    // Sets every cell of the board (padding bits stay zero)
+    void fill() {
+        uint64_t* d = data();
+        for (int y = 0; y < height; y++)
+            for (int j = 0; j < wordsPerRow; j++) {
+                int bits = width - 64 * j;
+                d[y * wordsPerRow + j] = bits >= 64 ? ~0ULL : bits > 0 ? (1ULL << bits) - 1 : 0;
+            }
+    }
+
+    // Number of set cells
+    int count() const {
+        int n = 0;
+        const uint64_t* d = data();
+        for (int i = 0; i < words; i++) n += __builtin_popcountll(d[i]);
+        return n;
+    }
+
+    bool any() const {
+        const uint64_t* d = data();
+        for (int i = 0; i < words; i++)
+            if (d[i]) return true;
+        return false;
+    }
+
+    bool operator==(const Bitboard& b) const {
+        const uint64_t *d = data(), *e = b.data();
+        for (int i = 0; i < words; i++)
+            if (d[i] != e[i]) return false;
+        return true;
+    }
+    bool operator!=(const Bitboard& b) const { return !(*this == b); }
+
+    Bitboard& operator|=(const Bitboard& b) {
+        uint64_t* d = data();
+        const uint64_t* e = b.data();
+        for (int i = 0; i < words; i++) d[i] |= e[i];
+        return *this;
+    }
+    Bitboard& operator&=(const Bitboard& b) {
+        uint64_t* d = data();
+        const uint64_t* e = b.data();
+        for (int i = 0; i < words; i++) d[i] &= e[i];
+        return *this;
+    }
+    // Clears every cell that is set in b
+    Bitboard& andNot(const Bitboard& b) {
+        uint64_t* d = data();
+        const uint64_t* e = b.data();
+        for (int i = 0; i < words; i++) d[i] &= ~e[i];
+        return *this;
+    }
+};
+
+// --- Kernels ---
+
+// Fills from the seed bits g towards higher bits (east) through the set bits of p, within one
+// word (Kogge-Stone occluded fill: six shift/AND/OR steps instead of up to 63)
+inline uint64_t fillEast(uint64_t g, uint64_t p) {
+    g |= p & (g << 1);  p &= p << 1;
+    g |= p & (g << 2);  p &= p << 2;
+    g |= p & (g << 4);  p &= p << 4;
+    g |= p & (g << 8);  p &= p << 8;
+    g |= p & (g << 16); p &= p << 16;
+    g |= p & (g << 32);
+    return g;
+}
+
+// Same towards lower bits (west)
+inline uint64_t fillWest(uint64_t g, uint64_t p) {
+    g |= p & (g >> 1);  p &= p >> 1;
+    g |= p & (g >> 2);  p &= p >> 2;
+    g |= p & (g >> 4);  p &= p >> 4;
+    g |= p & (g >> 8);  p &= p >> 8;
+    g |= p & (g >> 16); p &= p >> 16;
+    g |= p & (g >> 32);
+    return g;
+}
+
+// dilate() one word at a time, from word `from` on: the scalar fallback, the tail the AVX2
+// loop leaves over, and the reference the benchmark checks the AVX2 loop against
+inline void dilateScalar(const Bitboard& src, const Bitboard& passable, Bitboard& dst, int from = 0) {
+    const uint64_t* s = src.data();
+    const uint64_t* p = passable.data();
+    uint64_t* d = dst.data();
+    int row = src.wordsPerRow;
+    for (int i = from; i < src.words; i++) {
+        uint64_t c = s[i];
+        uint64_t grown = (c << 1) | (s[i - 1] >> 63) | (c >> 1) | (s[i + 1] << 63) | s[i + row] | s[i - row];
+        d[i] = c | (grown & p[i]);
+    }
+}
+
+// One step of growth: dst = src plus every passable cell next to src. Used where the number
+// of steps matters (timed reachability); a plain flood fill uses floodFill() below.
+inline void dilate(const Bitboard& src, const Bitboard& passable, Bitboard& dst) {
+    int i = 0;
+#ifdef __AVX2__
+    const uint64_t* s = src.data();
+    const uint64_t* p = passable.data();
+    uint64_t* d = dst.data();
+    int row = src.wordsPerRow;
+    for (; i + 4 <= src.words; i += 4) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i east = _mm256_or_si256(_mm256_slli_epi64(c, 1),
+                                       _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(s + i - 1)), 63));
+        __m256i west = _mm256_or_si256(_mm256_srli_epi64(c, 1),
+                                       _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(s + i + 1)), 63));
+        __m256i north = _mm256_loadu_si256((const __m256i*)(s + i + row)); // Cells below move up
+        __m256i south = _mm256_loadu_si256((const __m256i*)(s + i - row)); // Cells above move down
+        __m256i grown = _mm256_or_si256(_mm256_or_si256(east, west), _mm256_or_si256(north, south));
+        grown = _mm256_and_si256(grown, _mm256_loadu_si256((const __m256i*)(p + i)));
+        _mm256_storeu_si256((__m256i*)(d + i), _mm256_or_si256(c, grown));
+    }
+#endif
+    dilateScalar(src, passable, dst, i); // Scalar fallback and the last partial block
+}
+
+// Sets reach to every cell reachable from seed through passable cells (seed cells themselves
+// need not be passable, so a flood can start from the snake's head). Rows are filled
+// completely with fillEast/fillWest and the fill sweeps down and then up the board until
+// nothing changes, so a whole open area typically takes two or three sweeps.
+inline void floodFill(const Bitboard& seed, const Bitboard& passable, Bitboard& reach) {
+    reach = seed;
+    uint64_t* r = reach.data();
+    const uint64_t* p = passable.data();
+    int n = reach.wordsPerRow;
+
+    // Saturates row y after or-ing in the passable cells next to row `from`; rows that gain
+    // nothing new are skipped, which makes the final sweep that confirms the fill is done cheap
+    auto fillRow = [&](int y, int from) -> bool {
+        uint64_t* row = r + y * n;
+        const uint64_t* pass = p + y * n;
+        const uint64_t* other = r + from * n;
+        uint64_t incoming = 0;
+        for (int j = 0; j < n; j++) incoming |= other[j] & pass[j] & ~row[j];
+        if (!incoming && from != y) return false;
+        bool changed = false;
+        for (int j = 0; j < n; j++) {
+            uint64_t g = row[j] | (other[j] & pass[j]);
+            if (j > 0 && (row[j - 1] >> 63)) g |= pass[j] & 1; // Run continues across the word boundary
+            g = fillEast(g, pass[j] | row[j]);
+            changed |= g != row[j];
+            row[j] = g;
+        }
+        for (int j = n - 1; j >= 0; j--) {
+            uint64_t g = row[j];
+            if (j + 1 < n && (row[j + 1] & 1)) g |= pass[j] & (1ULL << 63);
+            g = fillWest(g, pass[j] | row[j]);
+            changed |= g != row[j];
+            row[j] = g;
+        }
+        return changed;
+    };
+
+    bool changed = true;
+    for (int y = 0; y < reach.height; y++) fillRow(y, y); // Spread the seeds along their rows
+    while (changed) {
+        changed = false;
+        for (int y = 1; y < reach.height; y++) changed |= fillRow(y, y - 1);
+        for (int y = reach.height - 2; y >= 0; y--) changed |= fillRow(y, y + 1);
+    }
+}
+
+// Sets reach to the cells reachable from seed when some blocked cells open up over time: release[k] (a cell
+// index y * width + x, or -1 for none) becomes passable at step firstRelease + k. This is the
+// snake's "reachable before the tail frees it" question: body cells open in tail-first order
+// as the snake moves. Grows one step at a time with dilate(); steps receives the number of
+// steps taken until nothing more could be reached.
+inline void timedFloodFill(const Bitboard& seed, Bitboard passable, const int* release, int releaseCount,
+                           int firstRelease, Bitboard& reach, int* steps = nullptr) {
+    Bitboard next(seed.width, seed.height);
+    reach = seed;
+    int lastRelease = firstRelease + releaseCount - 1;
+    int t = 0;
+    while (true) {
+        t++;
+        int k = t - firstRelease;
+        if (k >= 0 && k < releaseCount && release[k] >= 0)
+            passable.set(release[k] % passable.width, release[k] / passable.width);
+        dilate(reach, passable, next);
+        bool grew = next != reach;
+        std::swap(reach.storage, next.storage);
+        if (!grew && t >= lastRelease) break;
+    }
+    if (steps) *steps = t;
+}
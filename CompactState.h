@@ -0,0 +1,234 @@
+// CompactState.h
+// Small value-type copy of a level's state for search-based players (lookahead, MCTS).
+// Board keeps a heap-allocated Snake with one Point per segment and a byte per cell. Here the
+// body is a ring of 2-bit directions (32 segments per word) between 16-bit head and tail
+// coordinates, and occupancy is a bitboard of snake cells. Walls never change during a
+// level, so all copies share one wall bitboard.
+//
+// make() plays one move with Snake::move/Board::step rules and pushes an undo record;
+// unmake() takes the last move back exactly. Neither allocates once the history and the body
+// ring have grown to the depth and length being searched. What replaces an eaten fruit is
+// not known to a search, so a move that eats leaves the state without food until setFood().
+// SnakeBench checks make()/unmake() against Board::step() over random games before it runs.
+//
+// make()/unmake() on one state is the cheap path for a search: a move costs the same on any
+// board and at any length. A copy is not free: the snake bitboard (480 bytes at 70x30, about
+// 10 KB at 256x256), the direction ring (length / 4 bytes) and the undo history are copied
+// whole. Copy-construction allocates all three; assigning into a state of the same board size
+// reuses its buffers. Copy states to start independent searches (then clearHistory()), not
+// to explore a move.
+// Standard-size boards only (up to 256x256 cells, like the bitboards).
+#pragma once
+
+#include <cstdint> // For the packed coordinates and the direction ring
+#include <memory>  // For the shared wall bitboard
+#include <vector>  // For the direction ring and the undo history
+#include "SnakeCore.h" // Board, Snake, TickEvent, the direction constants
+
+class CompactState {
+public:
+    // 2-bit direction codes used in the body ring
+    enum { CODE_UP, CODE_DOWN, CODE_LEFT, CODE_RIGHT };
+
+    int16_t width = 0, height = 0;
+    int16_t headX = 0, headY = 0, tailX = 0, tailY = 0;
+    int length = 0;        // Segments, head and tail included
+    int pendingGrowth = 0; // Moves the tail still stays put for
+    uint8_t direction = CODE_RIGHT; // Code of the last move
+    int16_t foodX = -1, foodY = -1; // No food when foodX < 0
+    int score = 0, fruitCount = 0;
+    std::shared_ptr<const Bitboard> walls; // Shared by every copy of the level
+    Bitboard body;                         // Snake cells on the board
+
+    CompactState() {}
+
+    // Copies the current state of a standard-size board; returns false for a chunked board
+    bool load(const Board& board) {
+        const OccupancyGrid& grid = board.grid;
+        if (grid.chunked) return false;
+        const Snake& snake = *board.snake;
+        width = (int16_t)grid.width;
+        height = (int16_t)grid.height;
+        walls = std::make_shared<const Bitboard>(grid.wallBits);
+        body = grid.snakeBits;
+        headX = (int16_t)snake.head().x;
+        headY = (int16_t)snake.head().y;
+        tailX = (int16_t)snake.tail().x;
+        tailY = (int16_t)snake.tail().y;
+        length = snake.length;
+        pendingGrowth = snake.pendingGrowth;
+        direction = codeOf(snake.direction);
+        foodX = board.hasFood ? (int16_t)board.food.x : -1;
+        foodY = board.hasFood ? (int16_t)board.food.y : -1;
+        score = board.score;
+        fruitCount = board.fruitCount;
+
+        int capacity = 64;
+        while (capacity < 2 * length) capacity *= 2;
+        ring.assign(capacity / 32, 0);
+        ringTail = 0;
+        for (int i = length - 1; i > 0; i--) { // Steps from the tail towards the head
+            const Point& a = snake.segment(i);
+            const Point& b = snake.segment(i - 1);
+            setCode(length - 1 - i, b.x > a.x ? CODE_RIGHT : b.x < a.x ? CODE_LEFT : b.y < a.y ? CODE_UP : CODE_DOWN);
+        }
+        history.clear();
+        return true;
+    }
+
+    // Places the next fruit (not recorded in the history: set it between searches, not during)
+    void setFood(int x, int y) {
+        foodX = (int16_t)x;
+        foodY = (int16_t)y;
+    }
+
+    // Plays one move: dir is a DIR_* constant; DIR_NONE and reversals keep the current
+    // direction, as Snake::changeDirection() does. Returns TickEvent flags. A move that kills
+    // the snake returns EVENT_DIED and changes nothing (no undo record is pushed).
+    int make(char dir) {
+        uint8_t code = direction;
+        uint8_t requested = dir == DIR_NONE ? direction : codeOf(dir);
+        if (requested != (direction ^ 1)) code = requested; // Codes of opposite directions differ in bit 0
+
+        int nx = headX + DX[code], ny = headY + DY[code];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height || walls->test(nx, ny)) return EVENT_DIED;
+
+        // The tail leaves its cell first (unless the snake is growing), so the head may enter it
+        bool tailMoves = pendingGrowth == 0;
+        if (body.test(nx, ny) && !(tailMoves && nx == tailX && ny == tailY)) return EVENT_DIED;
+
+        Undo u;
+        u.direction = direction;
+        u.pendingGrowth = pendingGrowth;
+        u.foodX = foodX;
+        u.foodY = foodY;
+        u.tailMoved = tailMoves;
+        u.tailCode = 0;
+        if (tailMoves) {
+            u.tailCode = getCode(0);
+            if (onBoard(tailX, tailY)) body.reset(tailX, tailY);
+            tailX = (int16_t)(tailX + DX[u.tailCode]);
+            tailY = (int16_t)(tailY + DY[u.tailCode]);
+            ringTail++;
+            length--;
+        } else {
+            pendingGrowth--;
+        }
+        if (length == capacity()) grow();
+        setCode(length - 1, code); // The new step from the old head to the new one
+        length++;
+        headX = (int16_t)nx;
+        headY = (int16_t)ny;
+        body.set(nx, ny);
+        direction = code;
+
+        int events = EVENT_NONE;
+        if (nx == foodX && ny == foodY) {
+            bool money = (fruitCount + 1) % 5 == 0; // Every 5th fruit is a money fruit
+            events |= EVENT_ATE_FOOD | (money ? EVENT_MONEY : 0);
+            score += money ? 3 : 1;
+            fruitCount++;
+            pendingGrowth++;
+            foodX = foodY = -1;
+        }
+        u.events = (uint8_t)events;
+        history.push_back(u);
+        return events;
+    }
+
+    // Takes back the last successful make()
+    void unmake() {
+        Undo u = history.back();
+        history.pop_back();
+        if (u.events & EVENT_ATE_FOOD) {
+            fruitCount--;
+            score -= (u.events & EVENT_MONEY) ? 3 : 1;
+        }
+        foodX = u.foodX;
+        foodY = u.foodY;
+
+        body.reset(headX, headY);
+        length--;
+        uint8_t code = getCode(length - 1);
+        headX = (int16_t)(headX - DX[code]);
+        headY = (int16_t)(headY - DY[code]);
+
+        if (u.tailMoved) {
+            ringTail--;
+            setCode(0, u.tailCode); // The slot may have been reused by a deeper move
+            tailX = (int16_t)(tailX - DX[u.tailCode]);
+            tailY = (int16_t)(tailY - DY[u.tailCode]);
+            length++;
+            if (onBoard(tailX, tailY) && !walls->test(tailX, tailY)) body.set(tailX, tailY);
+        }
+        pendingGrowth = u.pendingGrowth;
+        direction = u.direction;
+    }
+
+    int depth() const { return (int)history.size(); }
+
+    // Drops the history, e.g. after copying a state to start a new search from it
+    void clearHistory() { history.clear(); }
+
+    // Segment i counted from the head (0 = head), by walking the ring; O(i)
+    Point segment(int i) const {
+        int x = headX, y = headY;
+        for (int k = length - 2; k >= length - 1 - i; k--) {
+            uint8_t code = getCode(k);
+            x -= DX[code];
+            y -= DY[code];
+        }
+        return Point(x, y);
+    }
+
+private:
+    struct Undo {
+        int16_t foodX, foodY; // Food before the move
+        int pendingGrowth;    // Growth before the move
+        uint8_t direction;    // Direction code before the move
+        uint8_t tailCode;     // Step the tail took (valid when tailMoved)
+        uint8_t events;       // TickEvent flags of the move
+        bool tailMoved;
+    };
+
+    static constexpr int DX[4] = {0, 0, -1, 1};
+    static constexpr int DY[4] = {-1, 1, 0, 0};
+
+    std::vector<uint64_t> ring; // Step k from the tail (k = 0 .. length-2), 2 bits each, as a ring
+    long long ringTail = 0;     // Ring position of step 0
+    std::vector<Undo> history;
+
+    static uint8_t codeOf(char dir) {
+        return dir == DIR_UP ? CODE_UP : dir == DIR_DOWN ? CODE_DOWN : dir == DIR_LEFT ? CODE_LEFT : CODE_RIGHT;
+    }
+
+    bool onBoard(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+
+    int capacity() const { return (int)ring.size() * 32; }
+
+    uint8_t getCode(int k) const {
+        uint64_t i = (uint64_t)(ringTail + k) & (uint64_t)(capacity() - 1);
+        return (uint8_t)((ring[i >> 5] >> (2 * (i & 31))) & 3);
+    }
+
+    void setCode(int k, uint8_t code) {
+        uint64_t i = (uint64_t)(ringTail + k) & (uint64_t)(capacity() - 1);
+        uint64_t& w = ring[i >> 5];
+        int shift = 2 * (i & 31);
+        w = (w & ~(3ULL << shift)) | ((uint64_t)code << shift);
+    }
+
+    // Doubles the ring, unwrapping the steps so step 0 is at position 0
+    void grow() {
+        std::vector<uint64_t> old;
+        old.swap(ring);
+        long long oldTail = ringTail;
+        int oldCapacity = (int)old.size() * 32;
+        ring.assign(old.size() * 2, 0);
+        ringTail = 0;
+        for (int k = 0; k < length - 1; k++) {
+            uint64_t i = (uint64_t)(oldTail + k) & (uint64_t)(oldCapacity - 1);
+            setCode(k, (uint8_t)((old[i >> 5] >> (2 * (i & 31))) & 3));
+        }
+    }
+};
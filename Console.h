@@ -0,0 +1,183 @@
+// Console.h
+// Thin platform layer for the console front-end: terminal setup, one-shot output,
+// keyboard reads, sleeping and the speaker. Windows uses the console API with
+// virtual terminal processing enabled; Linux and other POSIX systems use a raw-mode
+// termios terminal. Both are driven with ANSI escape sequences.
+#pragma once
+
+#include <chrono>  // For sleepMs()
+#include <string>  // For consoleWrite()
+#include <thread>  // For sleepMs()
+#ifdef _WIN32
+#include <conio.h>   // For _kbhit() and _getch() (console input)
+#include <windows.h> // For console modes, WriteFile and Beep
+#else
+#include <csignal>   // For restoring the terminal on Ctrl+C
+#include <poll.h>    // For waiting on stdin with a timeout
+#include <cstdlib>   // For atexit() and _Exit()
+#include <termios.h> // For non-canonical terminal input
+#include <unistd.h>  // For read() and write()
+#endif
+
+// --- Key Codes ---
+// Arrow keys are reported with these codes on every platform; other keys as their character
+const int KEY_ARROW_UP = 1000;
+const int KEY_ARROW_DOWN = 1001;
+const int KEY_ARROW_LEFT = 1002;
+const int KEY_ARROW_RIGHT = 1003;
+const int KEY_NONE = -1;
+
+// Pauses the calling thread
+inline void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+#ifdef _WIN32
+
+// Writes a whole frame to the console with one call
+inline void consoleWrite(const std::string& s) {
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), s.data(), (DWORD)s.size(), &written, NULL);
+}
+
+// Enables ANSI escape sequences and UTF-8 output, and hides the cursor
+inline void consoleInit() {
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    GetConsoleMode(out, &mode);
+    SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    SetConsoleOutputCP(CP_UTF8);
+    consoleWrite("\x1b[?25l"); // Hide the blinking cursor
+}
+
+// Shows the cursor again and resets colors
+inline void consoleRestore() {
+    consoleWrite("\x1b[0m\x1b[?25h");
+}
+
+// Returns true if a key press is waiting
+inline bool consoleKeyPressed() { return _kbhit() != 0; }
+
+// Reads one key press (blocks if none is waiting)
+inline int consoleReadKey() {
+    int key = _getch();
+    if (key == 0 || key == 224) { // Arrow keys send two scan codes
+        switch (_getch()) {
+            case 72: return KEY_ARROW_UP;
+            case 80: return KEY_ARROW_DOWN;
+            case 75: return KEY_ARROW_LEFT;
+            case 77: return KEY_ARROW_RIGHT;
+            default: return KEY_NONE;
+        }
+    }
+    return key;
+}
+
+// Waits up to timeoutMs for a key press; returns KEY_NONE if none arrives
+inline int consoleWaitKey(int timeoutMs) {
+    for (int waited = 0; !_kbhit(); waited++) {
+        if (waited >= timeoutMs) return KEY_NONE;
+        sleepMs(1);
+    }
+    return consoleReadKey();
+}
+
+// Plays a tone on the PC speaker (blocks for its duration)
+inline void consoleBeep(int frequency, int durationMs) {
+    Beep(frequency, durationMs);
+}
+
+#else
+
+inline termios savedTermios;       // Terminal settings to restore on exit
+inline bool terminalConfigured = false;
+
+// Writes a whole frame to the terminal, retrying only if the kernel accepts part of it
+inline void consoleWrite(const std::string& s) {
+    size_t done = 0;
+    while (done < s.size()) {
+        ssize_t n = write(STDOUT_FILENO, s.data() + done, s.size() - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+}
+
+// Puts the terminal back into the mode it was in before consoleInit()
+inline void consoleRestore() {
+    consoleWrite("\x1b[0m\x1b[?25h");
+    if (terminalConfigured) tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+    terminalConfigured = false;
+}
+
+// Switches stdin to raw, non-blocking reads and hides the cursor. Ctrl+C still works
+// (ISIG stays on) and output post-processing is kept so newlines still return the carriage.
+// The terminal is restored on normal exit and on Ctrl+C.
+inline void consoleInit() {
+    if (!terminalConfigured && tcgetattr(STDIN_FILENO, &savedTermios) == 0) {
+        termios raw = savedTermios;
+        raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);    // Byte-at-a-time input, no echo, no Ctrl+V
+        raw.c_iflag &= ~(IXON | ICRNL | BRKINT | ISTRIP); // No flow control or CR translation
+        raw.c_cflag |= CS8;
+        raw.c_cc[VMIN] = 0;  // read() returns immediately...
+        raw.c_cc[VTIME] = 0; // ...even when no key is waiting
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+        terminalConfigured = true;
+        atexit(consoleRestore);
+        signal(SIGINT, [](int) { consoleRestore(); _Exit(130); });
+    }
+    consoleWrite("\x1b[?25l"); // Hide the blinking cursor
+}
+
+inline int pendingKey = KEY_NONE; // Key read by consoleKeyPressed() but not yet consumed
+
+// Reads one byte from stdin without blocking; returns -1 if none is available
+inline int readByte() {
+    unsigned char c;
+    return read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+// Reads one key press without blocking, translating arrow escape sequences (ESC [ A-D)
+inline int pollKey() {
+    int c = readByte();
+    if (c != 27) return c < 0 ? KEY_NONE : c;
+    int bracket = readByte();
+    if (bracket != '[' && bracket != 'O') return 27;
+    switch (readByte()) {
+        case 'A': return KEY_ARROW_UP;
+        case 'B': return KEY_ARROW_DOWN;
+        case 'D': return KEY_ARROW_LEFT;
+        case 'C': return KEY_ARROW_RIGHT;
+        default: return KEY_NONE;
+    }
+}
+
+// Returns true if a key press is waiting
+inline bool consoleKeyPressed() {
+    if (pendingKey == KEY_NONE) pendingKey = pollKey();
+    return pendingKey != KEY_NONE;
+}
+
+// Reads one key press (blocks if none is waiting)
+inline int consoleReadKey() {
+    while (!consoleKeyPressed()) sleepMs(10);
+    int key = pendingKey;
+    pendingKey = KEY_NONE;
+    return key;
+}
+
+// Waits up to timeoutMs for a key press; returns KEY_NONE if none arrives
+inline int consoleWaitKey(int timeoutMs) {
+    if (pendingKey == KEY_NONE) {
+        pollfd in = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&in, 1, timeoutMs) <= 0) return KEY_NONE;
+    }
+    if (!consoleKeyPressed()) return KEY_NONE;
+    return consoleReadKey();
+}
+
+// Rings the terminal bell (terminals have no tone control; returns immediately)
+inline void consoleBeep(int, int) {
+    consoleWrite("\a");
+}
+
+#endif
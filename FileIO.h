@@ -0,0 +1,137 @@
+// FileIO.h
+// File helpers shared by the loaders and writers of level packs, score logs and snapshots:
+// read-only memory-mapped files, a CRC-32 for checking what was read back, and whole-file
+// writes that replace the old file in one step, so a crash leaves either the old or the new
+// file but never a mix of the two.
+#pragma once
+
+#include <cstdint> // For the checksum
+#include <cstdio>  // For writing files
+#include <string>  // For paths
+#include <vector>  // For the bytes written
+#ifdef _WIN32
+#include <windows.h>  // For CreateFileMapping, MapViewOfFile and MoveFileEx
+#include <io.h>       // For _get_osfhandle()
+#else
+#include <fcntl.h>    // For open()
+#include <sys/mman.h> // For mmap()
+#include <sys/stat.h> // For the file size
+#include <unistd.h>   // For close() and fsync()
+#endif
+
+// --- Mapped File ---
+// A read-only view of a whole file, mapped rather than copied into memory
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file; returns false if it cannot be opened. An empty file maps to no bytes.
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER length;
+        bool ok = GetFileSizeEx(file, &length) != 0;
+        if (ok && length.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            view = mapping ? (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            ok = view != nullptr;
+            bytes = ok ? (size_t)length.QuadPart : 0;
+        }
+        CloseHandle(file); // The mapping keeps the file open
+        if (!ok) close();
+        return ok;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = p != MAP_FAILED;
+            if (ok) {
+                view = (const char*)p;
+                bytes = (size_t)st.st_size;
+            }
+        }
+        ::close(fd); // The mapping keeps the file open
+        return ok;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        mapping = NULL;
+#else
+        if (view) munmap((void*)view, bytes);
+#endif
+        view = nullptr;
+        bytes = 0;
+    }
+
+    const char* data() const { return view; }
+    size_t size() const { return bytes; }
+
+private:
+    const char* view = nullptr;
+    size_t bytes = 0;
+#ifdef _WIN32
+    HANDLE mapping = NULL;
+#endif
+};
+
+// --- Checksum ---
+// CRC-32 (IEEE, as in zip and PNG)
+inline uint32_t crc32(const uint8_t* data, size_t length) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// --- Atomic Writes ---
+
+// Forces what was written to f onto the disk
+inline bool syncFile(FILE* f) {
+#ifdef _WIN32
+    return FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(f))) != 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// Renames from to to, replacing any file at to
+inline bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// Writes bytes to path + ".tmp", syncs it and renames it over path. Returns false on I/O
+// failure, leaving any old file at path as it was.
+inline bool writeFileAtomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::string temp = path + ".tmp";
+    FILE* f = fopen(temp.c_str(), "wb");
+    bool ok = f && fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size() && fflush(f) == 0 && syncFile(f);
+    if (f && fclose(f) != 0) ok = false;
+    ok = ok && replaceFile(temp, path);
+    if (!ok) remove(temp.c_str());
+    return ok;
+}
@@ -0,0 +1,68 @@
+// InputQueue.h
+// Platform-neutral input path: timestamped commands travel from whoever produces them
+// (the keyboard thread, later any other controller) to the game loop through a lock-free
+// queue, and turns wait in a short buffer so the simulation applies one per tick, in order.
+#pragma once
+
+#include <chrono>        // For command timestamps
+#include "SnakeCore.h"   // For the direction constants
+#include "SpscQueue.h"   // Lock-free queue between threads
+
+// --- Input Commands ---
+enum InputCommandType : unsigned char {
+    CMD_TURN,  // Turn the snake towards direction
+    CMD_PAUSE, // Toggle pause
+    CMD_QUIT   // End the program
+};
+
+struct InputCommand {
+    unsigned char type;                               // InputCommandType
+    char direction;                                   // DIR_* for CMD_TURN
+    std::chrono::steady_clock::time_point timestamp;  // When the key was read
+};
+
+typedef SpscQueue<InputCommand, 256> CommandQueue;
+
+#define TURN_LOOKAHEAD 3 // Turns that may wait for later ticks; further presses are dropped
+
+// Returns the direction opposite to dir
+inline char oppositeDirection(char dir) {
+    switch (dir) {
+        case DIR_UP: return DIR_DOWN;
+        case DIR_DOWN: return DIR_UP;
+        case DIR_LEFT: return DIR_RIGHT;
+        case DIR_RIGHT: return DIR_LEFT;
+        default: return DIR_NONE;
+    }
+}
+
+// --- Turn Buffer ---
+// Holds turns that have been pressed but not applied yet. Each turn is checked against the
+// direction the snake will have when it is applied (the previous buffered turn, or the current
+// direction), so quick sequences like up-then-left from moving right are both kept, while
+// no-op and 180-degree turns are discarded instead of wasting a tick.
+class TurnBuffer {
+public:
+    char turns[TURN_LOOKAHEAD]; // Pending turns, oldest first
+    int count = 0;              // Number of pending turns
+
+    // Queues a turn; returns false if it was redundant, a reversal, or the buffer is full
+    bool push(char dir, char currentDirection) {
+        char reference = count > 0 ? turns[count - 1] : currentDirection;
+        if (dir == reference || dir == oppositeDirection(reference)) return false;
+        if (count == TURN_LOOKAHEAD) return false;
+        turns[count++] = dir;
+        return true;
+    }
+
+    // Takes the turn for this tick (DIR_NONE if nothing is pending)
+    char pop() {
+        if (count == 0) return DIR_NONE;
+        char dir = turns[0];
+        for (int i = 1; i < count; i++) turns[i - 1] = turns[i];
+        count--;
+        return dir;
+    }
+
+    void clear() { count = 0; }
+};
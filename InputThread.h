@@ -0,0 +1,57 @@
+// InputThread.h
+// Reads the keyboard on its own thread so no key press is lost between ticks. Each
+// press is translated into a timestamped InputCommand and pushed onto a lock-free
+// CommandQueue that the game loop drains once per tick.
+#pragma once
+
+#include <atomic>         // For the stop flag
+#include <thread>         // For the reader thread
+#include "Console.h"      // For consoleWaitKey() and the key codes
+#include "InputQueue.h"   // For InputCommand and CommandQueue
+
+// Translates a key into a game command; returns false for keys the game ignores
+inline bool keyToCommand(int key, InputCommand& cmd) {
+    cmd.type = CMD_TURN;
+    cmd.direction = DIR_NONE;
+    if (key == KEY_ARROW_UP || key == 'w' || key == 'W') cmd.direction = DIR_UP;
+    else if (key == KEY_ARROW_DOWN || key == 's' || key == 'S') cmd.direction = DIR_DOWN;
+    else if (key == KEY_ARROW_LEFT || key == 'a' || key == 'A') cmd.direction = DIR_LEFT;
+    else if (key == KEY_ARROW_RIGHT || key == 'd' || key == 'D') cmd.direction = DIR_RIGHT;
+    else if (key == 'p' || key == 'P') cmd.type = CMD_PAUSE;
+    else if (key == 'q' || key == 'Q') cmd.type = CMD_QUIT;
+    else return false;
+    return true;
+}
+
+// --- Input Thread Class ---
+// Starts reading on construction and stops (joining the thread) on destruction
+class InputThread {
+public:
+    CommandQueue& queue;           // Where commands go; the game loop is the only consumer
+    std::atomic<bool> running;     // Cleared to stop the reader
+    std::atomic<long long> dropped; // Commands lost because the game loop fell behind
+
+    InputThread(CommandQueue& queue) : queue(queue), running(true), dropped(0), reader([this] { run(); }) {}
+
+    ~InputThread() {
+        running = false;
+        reader.join(); // The reader wakes at least every 50 ms to check the flag
+    }
+
+    InputThread(const InputThread&) = delete;
+    InputThread& operator=(const InputThread&) = delete;
+
+private:
+    std::thread reader; // Declared last so it starts after the other members are ready
+
+    void run() {
+        while (running) {
+            int key = consoleWaitKey(50);
+            if (key == KEY_NONE) continue;
+            InputCommand cmd;
+            if (!keyToCommand(key, cmd)) continue;
+            cmd.timestamp = std::chrono::steady_clock::now();
+            if (!queue.tryPush(cmd)) dropped++;
+        }
+    }
+};
@@ -0,0 +1,345 @@
+// LevelPack.h
+// Levels loaded from a file instead of the built-in patterns. A pack holds any number of
+// levels, either as ASCII art or in a compact binary form; each level is compiled once into a
+// LevelLayout (wall cells, wall bitboard and runs, free cell index, start cell), and every
+// board of that level shares the compiled layout.
+//
+// The file is memory-mapped, not read, and stays mapped while the pack is open. Opening a pack
+// only finds where each level starts (the binary form has an offset table, the text form is
+// scanned for "level" lines) and checks what that costs nothing extra to check: board sizes,
+// start cells and binary record lengths. Each level is then compiled straight from the mapping
+// the first time it is played, so large packs open at once; packs under EAGER_COMPILE_BYTES
+// are compiled whole by open(), which then reports any malformed level. A level that fails
+// its later compile has no layout, and layoutError() gives the reason. layout() locks, so any
+// number of threads can share the pack.
+//
+// Text form:
+//   ; comment                 (lines starting with ';', and blank lines, are skipped)
+//   level Name of the level   (starts a level; the art follows, one line per board row)
+//   ####################
+//   #........#.........#      '#' wall, '.' or ' ' floor
+//   #..@...............#      '@' head of the starting snake (floor; the snake points right
+//   ####################      and trails to the left). Without one it starts in the middle.
+// Short rows are padded with floor. Boards are MIN_BOARD_WIDTH x MIN_BOARD_HEIGHT up to
+// MAX_BOARD_SIZE cells on a side.
+//
+// Binary form (integers little-endian):
+//   "SNKL" magic (4 bytes), version (1 byte), level count (4 bytes)
+//   offset of each level's record from the start of the file (8 bytes each)
+//   record: width, height, start x, start y, name length (2 bytes each), name,
+//           wall bits, row-major, lowest bit first, (width * height + 7) / 8 bytes
+#pragma once
+
+#include <algorithm> // For std::max
+#include <cstdint> // For the binary records
+#include <cstdio>  // For writing binary packs
+#include <cstring> // For memchr and memcmp
+#include <memory>  // For the compiled layouts
+#include <mutex>   // For compiling on first use from several threads
+#include <string>  // For names, paths and errors
+#include <vector>  // For the level index
+#include "SnakeCore.h" // LevelLayout, LevelSource and the board limits
+#include "FileIO.h"    // MappedFile
+
+#define LEVEL_PACK_VERSION 1
+#define EAGER_COMPILE_BYTES (1 << 20) // Packs smaller than this are compiled when opened
+
+// --- Level Pack ---
+class LevelPack : public LevelSource {
+public:
+    LevelPack() {}
+
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    // Opens a pack file and indexes its levels (compiling them all if the file is small).
+    // Returns false with a message in error if the file cannot be read, is not a pack, holds no
+    // level, or has a level whose size, start cell or record length is wrong (or, for a small
+    // pack, that is malformed in any way).
+    bool open(const std::string& path, std::string& error) {
+        layouts.clear();
+        errors.clear();
+        spans.clear();
+        if (!file.open(path)) {
+            error = "cannot read " + path;
+            return false;
+        }
+        binary = file.size() >= 5 && memcmp(file.data(), "SNKL", 4) == 0;
+        if (!(binary ? indexBinary(error) : indexText(error))) return fail();
+        if (spans.empty()) {
+            error = path + " holds no level";
+            return fail();
+        }
+        layouts.resize(spans.size());
+        errors.resize(spans.size());
+        if (file.size() < EAGER_COMPILE_BYTES) {
+            for (size_t i = 0; i < spans.size(); i++)
+                if (!compile((int)i, error)) return fail();
+        }
+        return true;
+    }
+
+    int levelCount() const override { return (int)spans.size(); }
+
+    // The level's layout, compiled on first use; nullptr if it does not exist or is malformed
+    std::shared_ptr<const LevelLayout> layout(int level) override {
+        if (level < 1 || level > levelCount()) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!layouts[level - 1] && errors[level - 1].empty()) compile(level - 1, errors[level - 1]);
+        return layouts[level - 1];
+    }
+
+    std::string layoutError(int level) override {
+        if (level < 1 || level > levelCount()) return "level " + std::to_string(level) + " does not exist";
+        std::lock_guard<std::mutex> lock(mutex);
+        return errors[level - 1];
+    }
+
+    bool boardSize(int level, int& width, int& height) override {
+        if (level < 1 || level > levelCount()) return false;
+        width = spans[level - 1].width;
+        height = spans[level - 1].height;
+        return true;
+    }
+
+    // Writes every level of the pack to path in the binary form, compiling those not played yet
+    bool saveBinary(const std::string& path, std::string& error) {
+        std::vector<std::shared_ptr<const LevelLayout>> levels;
+        for (int l = 1; l <= levelCount(); l++) {
+            levels.push_back(layout(l));
+            if (!levels.back()) {
+                error = layoutError(l);
+                return false;
+            }
+        }
+        if (!writeBinary(path, levels)) {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // Writes layouts as a binary pack; returns false on I/O failure
+    static bool writeBinary(const std::string& path, const std::vector<std::shared_ptr<const LevelLayout>>& levels) {
+        std::vector<uint8_t> out;
+        out.insert(out.end(), {'S', 'N', 'K', 'L', LEVEL_PACK_VERSION});
+        put(out, levels.size(), 4);
+        size_t table = out.size();
+        out.resize(out.size() + 8 * levels.size());
+        for (size_t i = 0; i < levels.size(); i++) {
+            const LevelLayout& l = *levels[i];
+            for (int b = 0; b < 8; b++) out[table + 8 * i + b] = (uint8_t)((uint64_t)out.size() >> (8 * b));
+            put(out, (uint64_t)l.width, 2);
+            put(out, (uint64_t)l.height, 2);
+            put(out, (uint64_t)l.startX, 2);
+            put(out, (uint64_t)l.startY, 2);
+            size_t nameLength = l.name.size() < 0xFFFF ? l.name.size() : 0xFFFF;
+            put(out, nameLength, 2);
+            out.insert(out.end(), l.name.begin(), l.name.begin() + nameLength);
+            size_t bits = out.size();
+            out.resize(out.size() + ((size_t)l.width * l.height + 7) / 8, 0);
+            for (size_t c = 0; c < l.cells.size(); c++)
+                if (l.cells[c] == CELL_WALL) out[bits + c / 8] |= (uint8_t)(1 << (c % 8));
+        }
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+        return fclose(f) == 0 && ok;
+    }
+
+private:
+    // Where a level is in the file and what open() learned about it
+    struct Span {
+        size_t begin, end;     // Bytes of the level (text: "level" line to the next)
+        int width, height;     // Board size
+    };
+
+    MappedFile file;
+    bool binary = false;
+    std::vector<Span> spans;
+    std::mutex mutex; // Guards layouts and errors
+    std::vector<std::shared_ptr<const LevelLayout>> layouts; // Compiled levels, nullptr until played
+    std::vector<std::string> errors; // Why a level failed to compile; empty if it did not (yet)
+
+    // Drops what a failed open() indexed
+    bool fail() {
+        layouts.clear();
+        errors.clear();
+        spans.clear();
+        file.close();
+        return false;
+    }
+
+    // Checks a board size against the limits every board must keep
+    static bool checkSize(int level, int width, int height, std::string& error) {
+        if (width >= MIN_BOARD_WIDTH && height >= MIN_BOARD_HEIGHT && width <= MAX_BOARD_SIZE && height <= MAX_BOARD_SIZE)
+            return true;
+        error = "level " + std::to_string(level) + ": board must be " + std::to_string(MIN_BOARD_WIDTH) + "x" +
+                std::to_string(MIN_BOARD_HEIGHT) + " to " + std::to_string(MAX_BOARD_SIZE) + "x" +
+                std::to_string(MAX_BOARD_SIZE);
+        return false;
+    }
+
+    static void put(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int b = 0; b < bytes; b++) out.push_back((uint8_t)(value >> (8 * b)));
+    }
+    uint64_t get(size_t pos, int bytes) const {
+        uint64_t value = 0;
+        for (int b = 0; b < bytes; b++) value |= (uint64_t)(uint8_t)file.data()[pos + b] << (8 * b);
+        return value;
+    }
+
+    // Reads the offset table of a binary pack
+    bool indexBinary(std::string& error) {
+        if (file.size() < 9 || (uint8_t)file.data()[4] > LEVEL_PACK_VERSION) {
+            error = "unsupported level pack version";
+            return false;
+        }
+        uint64_t count = get(5, 4);
+        if (9 + 8 * count > file.size()) {
+            error = "level pack is truncated";
+            return false;
+        }
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t begin = get(9 + 8 * i, 8);
+            uint64_t end = i + 1 < count ? get(9 + 8 * (i + 1), 8) : file.size();
+            if (begin > end || end > file.size()) {
+                error = "level pack is truncated";
+                return false;
+            }
+            // The record header: size, start cell and a record long enough for its wall bits
+            std::string level = "level " + std::to_string(i + 1) + ": ";
+            if (end - begin < 10) {
+                error = level + "record is truncated";
+                return false;
+            }
+            int width = (int)get(begin, 2), height = (int)get(begin + 2, 2);
+            int startX = (int)get(begin + 4, 2), startY = (int)get(begin + 6, 2);
+            if (!checkSize((int)i + 1, width, height, error)) return false;
+            uint64_t bits = begin + 10 + get(begin + 8, 2);
+            if (bits > end || ((uint64_t)width * height + 7) / 8 > end - bits) {
+                error = level + "record is truncated";
+                return false;
+            }
+            if (startX >= width || startY >= height) {
+                error = level + "the snake starts outside the board";
+                return false;
+            }
+            spans.push_back({(size_t)begin, (size_t)end, width, height});
+        }
+        return true;
+    }
+
+    // Finds the "level" lines of a text pack, measuring each level's art on the way
+    bool indexText(std::string& error) {
+        const char* data = file.data();
+        size_t n = file.size(), pos = 0;
+        while (pos < n) {
+            const char* eol = (const char*)memchr(data + pos, '\n', n - pos);
+            size_t next = eol ? (size_t)(eol - data) + 1 : n;
+            size_t stop = eol ? (size_t)(eol - data) : n;
+            if (stop > pos && data[stop - 1] == '\r') stop--;
+            if (next - pos >= 5 && memcmp(data + pos, "level", 5) == 0 &&
+                (next - pos == 5 || data[pos + 5] == ' ' || data[pos + 5] == '\t' || data[pos + 5] == '\r' || data[pos + 5] == '\n')) {
+                if (!spans.empty()) {
+                    spans.back().end = pos;
+                    if (!checkSize((int)spans.size(), spans.back().width, spans.back().height, error)) return false;
+                }
+                spans.push_back({pos, n, 0, 0});
+            } else if (!spans.empty() && stop > pos && data[pos] != ';') { // A row of art (as parseText() sees it)
+                Span& s = spans.back();
+                s.width = std::max(s.width, (int)std::min(stop - pos, (size_t)MAX_BOARD_SIZE + 1));
+                if (s.height <= MAX_BOARD_SIZE) s.height++;
+            }
+            pos = next;
+        }
+        return spans.empty() || checkSize((int)spans.size(), spans.back().width, spans.back().height, error);
+    }
+
+    // Compiles level index i into layouts[i] (its size and start cell were checked by open())
+    bool compile(int i, std::string& error) {
+        std::shared_ptr<LevelLayout> l = std::make_shared<LevelLayout>();
+        bool ok = true;
+        if (binary) decodeBinary(spans[i].begin, *l);
+        else ok = parseText(spans[i].begin, spans[i].end, *l, error);
+        if (ok && l->cells[(size_t)l->startY * l->width + l->startX] == CELL_WALL) {
+            error = "the snake starts inside a wall";
+            ok = false;
+        }
+        if (ok) {
+            l->compile();
+            if (l->emptyCount < 2) {
+                error = "no room for food";
+                ok = false;
+            }
+        }
+        if (!ok) {
+            error = "level " + std::to_string(i + 1) + ": " + error;
+            return false;
+        }
+        layouts[i] = l;
+        return true;
+    }
+
+    bool parseText(size_t begin, size_t end, LevelLayout& l, std::string& error) const {
+        const char* data = file.data();
+        std::vector<std::pair<size_t, size_t>> rows; // Art lines without their line break
+        bool header = true;
+        l.startX = l.startY = -1;
+        for (size_t pos = begin; pos < end;) {
+            const char* eol = (const char*)memchr(data + pos, '\n', end - pos);
+            size_t next = eol ? (size_t)(eol - data) + 1 : end;
+            size_t stop = eol ? (size_t)(eol - data) : end;
+            if (stop > pos && data[stop - 1] == '\r') stop--;
+            if (header) { // "level" and the name
+                size_t s = pos + 5;
+                while (s < stop && (data[s] == ' ' || data[s] == '\t')) s++;
+                l.name.assign(data + s, stop - s);
+                header = false;
+            } else if (stop > pos && data[pos] != ';') {
+                rows.push_back({pos, stop});
+            }
+            pos = next;
+        }
+        l.height = (int)rows.size();
+        l.width = 0;
+        for (const std::pair<size_t, size_t>& r : rows) l.width = std::max(l.width, (int)(r.second - r.first));
+        l.cells.assign((size_t)l.width * l.height, CELL_EMPTY);
+        for (int y = 0; y < l.height; y++) {
+            for (size_t p = rows[y].first; p < rows[y].second; p++) {
+                int x = (int)(p - rows[y].first);
+                char c = data[p];
+                if (c == '#') {
+                    l.cells[(size_t)y * l.width + x] = CELL_WALL;
+                } else if (c == '@') {
+                    l.startX = x;
+                    l.startY = y;
+                } else if (c != '.' && c != ' ') {
+                    error = "unknown character '" + std::string(1, c) + "' in row " + std::to_string(y + 1);
+                    return false;
+                }
+            }
+        }
+        if (l.startX < 0) {
+            l.startX = l.width / 2;
+            l.startY = l.height / 2;
+        }
+        return true;
+    }
+
+    // Reads a binary record (open() checked its length)
+    void decodeBinary(size_t begin, LevelLayout& l) const {
+        l.width = (int)get(begin, 2);
+        l.height = (int)get(begin + 2, 2);
+        l.startX = (int)get(begin + 4, 2);
+        l.startY = (int)get(begin + 6, 2);
+        size_t nameLength = (size_t)get(begin + 8, 2);
+        size_t bits = begin + 10 + nameLength;
+        size_t cellCount = (size_t)l.width * l.height;
+        l.name.assign(file.data() + begin + 10, nameLength);
+        l.cells.assign(cellCount, CELL_EMPTY);
+        const uint8_t* wall = (const uint8_t*)file.data() + bits;
+        for (size_t c = 0; c < cellCount; c++)
+            if ((wall[c / 8] >> (c % 8)) & 1) l.cells[c] = CELL_WALL;
+    }
+};
@@ -0,0 +1,217 @@
+// MazeGenerator.h
+// Procedural maze levels for any board size, for a level rotation beyond the built-in six.
+// A candidate is a braided maze: a random spanning tree carved through a grid of rooms (so
+// every room is reachable), with part of the remaining walls knocked out again so the snake
+// has loops to turn in, plus short free-standing bars. Difficulty (0 to 1) narrows the rooms,
+// keeps more walls and adds more bars. The bars can cut off part of the board or box in the
+// start, so every candidate is validated before it is used:
+//   - every free cell must be reachable from the start (spawnFood() picks any free cell, and
+//     food in a pocket the snake cannot reach would stall the level), and
+//   - the snake must not start trapped: the start cell and the cell ahead of it (the snake
+//     starts moving right) must be free.
+// Reachability is one bit-parallel flood fill (Bitboard.h) per candidate, and candidates are
+// generated and checked on every core through the work-stealing pool. Which layouts come out
+// depends only on the seed, not on the number of threads or on scheduling.
+#pragma once
+
+#include <algorithm> // For std::max
+#include <atomic>  // For the candidate counters
+#include <chrono>  // For timing a run
+#include <cmath>   // For std::lround
+#include <memory>  // For the layouts
+#include <string>  // For level names
+#include <vector>  // For the room grid and the results
+#include "SnakeCore.h"      // LevelLayout, LevelSource, Rng, Bitboard
+#include "WorkStealingPool.h" // Parallel generation
+
+// --- Generated Levels ---
+// A fixed list of compiled layouts as a level source (levels 1 .. size())
+class GeneratedLevels : public LevelSource {
+public:
+    std::vector<std::shared_ptr<const LevelLayout>> layouts;
+
+    int levelCount() const override { return (int)layouts.size(); }
+
+    std::shared_ptr<const LevelLayout> layout(int level) override {
+        if (level < 1 || level > levelCount()) return nullptr;
+        return layouts[level - 1];
+    }
+};
+
+// --- Maze Generator ---
+class MazeGenerator {
+public:
+    // Why a candidate was thrown away
+    enum Verdict { MAZE_OK, MAZE_DISCONNECTED, MAZE_TRAPPED };
+
+    // Counts of a generate() run
+    struct Stats {
+        long long candidates = 0;   // Candidates built and validated
+        long long disconnected = 0; // Rejected: free cells the start cannot reach
+        long long trapped = 0;      // Rejected: the snake starts against a wall
+        double seconds = 0;
+    };
+
+    int width, height;  // Board size (clamped like GameConfig::setSize)
+    double difficulty;  // 0 (wide open rooms) to 1 (narrow corridors, many walls)
+
+    MazeGenerator(int width, int height, double difficulty) : difficulty(difficulty < 0 ? 0 : difficulty > 1 ? 1 : difficulty) {
+        GameConfig size;
+        size.setSize(width, height);
+        this->width = size.width;
+        this->height = size.height;
+    }
+
+    // Rejected candidates of one level before its next candidates are built without bars
+    static const int MAX_TRIES = 64;
+
+    // Builds one candidate from a seed; it has not been validated
+    std::shared_ptr<LevelLayout> candidate(uint64_t seed, bool withBars = true) const {
+        Rng rng(seed);
+        std::shared_ptr<LevelLayout> layout = std::make_shared<LevelLayout>();
+        LevelLayout& l = *layout;
+        l.width = width;
+        l.height = height;
+        l.cells.assign((size_t)width * height, CELL_EMPTY);
+
+        // Rooms between evenly spaced wall lines; lines 0 and the last are the outer border
+        int room = (int)std::lround(6 - 4 * difficulty); // Room width: 6 cells when easy, 2 when hard
+        int roomsX = std::max(1, (width - 1) / (room + 1)), roomsY = std::max(1, (height - 1) / (room + 1));
+        std::vector<int> lineX(roomsX + 1), lineY(roomsY + 1);
+        for (int i = 0; i <= roomsX; i++) lineX[i] = (int)((long long)i * (width - 1) / roomsX);
+        for (int j = 0; j <= roomsY; j++) lineY[j] = (int)((long long)j * (height - 1) / roomsY);
+        for (int x : lineX)
+            for (int y = 0; y < height; y++) l.cells[(size_t)y * width + x] = CELL_WALL;
+        for (int y : lineY)
+            for (int x = 0; x < width; x++) l.cells[(size_t)y * width + x] = CELL_WALL;
+
+        // Walls between rooms: east wall of room (i, j) is eastOpen[j * roomsX + i], south wall southOpen[...]
+        std::vector<char> eastOpen((size_t)roomsX * roomsY, 0), southOpen((size_t)roomsX * roomsY, 0);
+        carveSpanningTree(rng, roomsX, roomsY, eastOpen, southOpen);
+        double braid = 0.8 - 0.6 * difficulty; // Share of the remaining inner walls knocked out
+        for (int j = 0; j < roomsY; j++) {
+            for (int i = 0; i < roomsX; i++) {
+                size_t r = (size_t)j * roomsX + i;
+                if (i + 1 < roomsX && !eastOpen[r] && rng.below(1000) < braid * 1000) eastOpen[r] = 1;
+                if (j + 1 < roomsY && !southOpen[r] && rng.below(1000) < braid * 1000) southOpen[r] = 1;
+                if (i + 1 < roomsX && eastOpen[r])
+                    for (int y = lineY[j] + 1; y < lineY[j + 1]; y++) l.cells[(size_t)y * width + lineX[i + 1]] = CELL_EMPTY;
+                if (j + 1 < roomsY && southOpen[r])
+                    for (int x = lineX[i] + 1; x < lineX[i + 1]; x++) l.cells[(size_t)lineY[j + 1] * width + x] = CELL_EMPTY;
+            }
+        }
+        // Posts left standing alone where four open walls meet are removed too
+        for (int j = 1; j < roomsY; j++)
+            for (int i = 1; i < roomsX; i++)
+                if (eastOpen[(size_t)(j - 1) * roomsX + i - 1] && eastOpen[(size_t)j * roomsX + i - 1] &&
+                    southOpen[(size_t)(j - 1) * roomsX + i - 1] && southOpen[(size_t)(j - 1) * roomsX + i])
+                    l.cells[(size_t)lineY[j] * width + lineX[i]] = CELL_EMPTY;
+
+        // Bars: short wall segments anywhere inside the border
+        int bars = withBars ? (int)(difficulty * roomsX * roomsY / 8) : 0;
+        for (int b = 0; b < bars; b++) {
+            bool horizontal = rng.below(2) == 0;
+            int length = 2 + (int)rng.below((uint32_t)room);
+            int x = 1 + (int)rng.below((uint32_t)(width - 2)), y = 1 + (int)rng.below((uint32_t)(height - 2));
+            for (int k = 0; k < length; k++) {
+                int bx = horizontal ? x + k : x, by = horizontal ? y : y + k;
+                if (bx < width - 1 && by < height - 1) l.cells[(size_t)by * width + bx] = CELL_WALL;
+            }
+        }
+
+        // Start at the left edge of the middle room row, heading into the room
+        l.startX = 1;
+        l.startY = lineY[roomsY / 2] + 1 + (lineY[roomsY / 2 + 1] - lineY[roomsY / 2] - 1) / 2;
+        l.name = "Maze";
+        l.compile();
+        return layout;
+    }
+
+    // Checks a layout for regions the start cannot reach and for a trapped start
+    static Verdict validate(const LevelLayout& l) {
+        auto wall = [&](int x, int y) {
+            return x < 0 || x >= l.width || y < 0 || y >= l.height || l.cells[(size_t)y * l.width + x] == CELL_WALL;
+        };
+        if (wall(l.startX, l.startY) || wall(l.startX + 1, l.startY)) return MAZE_TRAPPED;
+
+        Bitboard passable(l.width, l.height), seed(l.width, l.height), reach;
+        if (l.chunked) { // Large layouts keep no wall bitboard
+            for (int y = 0; y < l.height; y++)
+                for (int x = 0; x < l.width; x++)
+                    if (!wall(x, y)) passable.set(x, y);
+        } else {
+            passable.fill();
+            passable.andNot(l.wallBits);
+        }
+        seed.set(l.startX, l.startY);
+        floodFill(seed, passable, reach);
+        return reach.count() == l.emptyCount ? MAZE_OK : MAZE_DISCONNECTED;
+    }
+
+    // Generates count valid layouts on threads workers. Layout i is the first valid candidate
+    // of the i-th seed sequence drawn from seed, so the result is the same for any thread count.
+    // A level that keeps failing drops its bars after MAX_TRIES, so generation always ends.
+    std::vector<std::shared_ptr<const LevelLayout>> generate(int count, uint64_t seed, int threads, Stats* stats = nullptr) const {
+        std::vector<std::shared_ptr<const LevelLayout>> result(count);
+        std::atomic<long long> candidates(0), disconnected(0), trapped(0);
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        Rng seeds(seed);
+        {
+            WorkStealingPool pool(threads);
+            for (int i = 0; i < count; i++) {
+                uint64_t levelSeed = seeds.next64();
+                pool.submit([&, i, levelSeed](int) {
+                    Rng tries(levelSeed);
+                    for (int attempt = 0;; attempt++) {
+                        std::shared_ptr<LevelLayout> l = candidate(tries.next64(), attempt < MAX_TRIES);
+                        candidates++;
+                        Verdict v = validate(*l);
+                        if (v == MAZE_OK) {
+                            l->name = "Maze " + std::to_string(i + 1);
+                            result[i] = l;
+                            return;
+                        }
+                        (v == MAZE_TRAPPED ? trapped : disconnected)++;
+                    }
+                });
+            }
+            pool.wait();
+        }
+        if (stats) {
+            stats->candidates = candidates;
+            stats->disconnected = disconnected;
+            stats->trapped = trapped;
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+        return result;
+    }
+
+private:
+    // Opens the walls of a random spanning tree of the rooms (depth-first, with an explicit stack)
+    static void carveSpanningTree(Rng& rng, int roomsX, int roomsY, std::vector<char>& eastOpen, std::vector<char>& southOpen) {
+        std::vector<char> visited((size_t)roomsX * roomsY, 0);
+        std::vector<int> stack;
+        int first = (int)rng.below((uint32_t)(roomsX * roomsY));
+        visited[first] = 1;
+        stack.push_back(first);
+        while (!stack.empty()) {
+            int r = stack.back(), i = r % roomsX, j = r / roomsX;
+            int next[4], n = 0;
+            if (i > 0 && !visited[r - 1]) next[n++] = r - 1;
+            if (i + 1 < roomsX && !visited[r + 1]) next[n++] = r + 1;
+            if (j > 0 && !visited[r - roomsX]) next[n++] = r - roomsX;
+            if (j + 1 < roomsY && !visited[r + roomsX]) next[n++] = r + roomsX;
+            if (n == 0) {
+                stack.pop_back();
+                continue;
+            }
+            int to = next[rng.below((uint32_t)n)];
+            if (to == r + 1) eastOpen[r] = 1;
+            else if (to == r - 1) eastOpen[to] = 1;
+            else if (to == r + roomsX) southOpen[r] = 1;
+            else southOpen[to] = 1;
+            visited[to] = 1;
+            stack.push_back(to);
+        }
+    }
+};
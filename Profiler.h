@@ -0,0 +1,212 @@
+// Profiler.h
+// Per-phase timing for the game loop: how long input, the simulation (move, spawn), drawing,
+// presenting, the sound and the tick sleep take, tick by tick. Each phase records into a
+// latency histogram (HDR-style log-linear buckets: 32 per power of two, so any recorded value
+// is known to within about 3%); recording is a few relaxed atomic adds, with no locks or
+// allocation, so any thread may record. Optionally every phase is also kept as a Chrome
+// trace event ("Trace Event Format" JSON, viewable in chrome://tracing or Perfetto) to look
+// at individual slow ticks instead of percentiles.
+#pragma once
+
+#include <algorithm> // For std::min
+#include <atomic>    // For the bucket counters and the trace cursor
+#include <chrono>    // For steady_clock
+#include <cstdint>   // For uint64_t
+#include <cstdio>    // For the reports and the trace file
+#include <memory>    // For the trace buffer
+#include <string>    // For the trace file path
+
+// --- Phases ---
+enum ProfilePhase {
+    PHASE_INPUT,     // Draining the key and autopilot command queues
+    PHASE_AUTOPILOT, // Planning the autopilot's next turn
+    PHASE_MOVE,      // Moving the snake and collision checks (Board::step)
+    PHASE_SPAWN,     // Placing the next fruit (Board::step)
+    PHASE_DRAW,      // Drawing the frame into the renderer's back buffer
+    PHASE_PRESENT,   // Diffing the frame and writing it to the terminal
+    PHASE_SOUND,     // Playing the eat sound
+    PHASE_BANNER,    // Ticks spent with a banner holding the game (level cleared, game over)
+    PHASE_SLEEP,     // Waiting for the next tick's deadline
+    PHASE_TICK,      // Whole tick from input to the end of the sleep
+    PHASE_COUNT
+};
+
+inline const char* phaseName(int phase) {
+    static const char* names[PHASE_COUNT] = {"input", "autopilot", "move",   "spawn", "draw",
+                                             "present", "sound",   "banner", "sleep", "tick"};
+    return names[phase];
+}
+
+// --- Latency Histogram ---
+// Counts of nanosecond values in log-linear buckets. Values below 32 ns get a bucket each;
+// above that, each power of two is split into 32 equal buckets.
+class LatencyHistogram {
+public:
+    static const int SUB_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() { clear(); }
+
+    void clear() {
+        for (int i = 0; i < BUCKETS; i++) counts[i].store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        maxValue.store(0, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t ns) {
+        counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t m = maxValue.load(std::memory_order_relaxed);
+        while (ns > m && !maxValue.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+    double mean() const { return count() ? (double)sum.load(std::memory_order_relaxed) / count() : 0.0; }
+
+    // Value at quantile q (0..1): the highest value of the bucket holding it, capped at the maximum
+    uint64_t percentile(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = (uint64_t)(q * (n - 1)) + 1, seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(bucketHigh(i), max());
+        }
+        return max();
+    }
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> total, sum, maxValue;
+
+    static int bucketOf(uint64_t v) {
+        if (v < (uint64_t)SUB_BUCKETS) return (int)v;
+        int shift = 63 - __builtin_clzll(v) - SUB_BITS; // Keep the top SUB_BITS + 1 bits
+        return (shift + 1) * SUB_BUCKETS + (int)((v >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    static uint64_t bucketHigh(int i) {
+        if (i < SUB_BUCKETS) return (uint64_t)i;
+        int shift = i / SUB_BUCKETS - 1;
+        uint64_t low = (uint64_t)(SUB_BUCKETS + i % SUB_BUCKETS) << shift;
+        return low + ((1ULL << shift) - 1);
+    }
+};
+
+// --- Profiler ---
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // One finished phase, for the trace
+    struct TraceEvent {
+        uint64_t start;     // ns since the profiler was created
+        uint64_t duration;  // ns
+        uint32_t thread;    // Small id of the recording thread
+        uint32_t phase;
+    };
+
+    LatencyHistogram phases[PHASE_COUNT];
+
+    Profiler() : origin(Clock::now()), traceCapacity(0), traceNext(0) {}
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Starts keeping trace events, up to capacity of them (later ones are counted as dropped).
+    // Call before recording starts.
+    void enableTrace(size_t capacity) {
+        trace.reset(new TraceEvent[capacity]);
+        traceCapacity = capacity;
+        traceNext.store(0, std::memory_order_relaxed);
+    }
+
+    Clock::time_point now() const { return Clock::now(); }
+
+    // Records a phase that ran from begin until now
+    void record(int phase, Clock::time_point begin) { record(phase, begin, Clock::now()); }
+
+    void record(int phase, Clock::time_point begin, Clock::time_point end) {
+        uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        phases[phase].record(ns);
+        if (!traceCapacity) return;
+        size_t slot = traceNext.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= traceCapacity) return;
+        TraceEvent& e = trace[slot];
+        e.start = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(begin - origin).count();
+        e.duration = ns;
+        e.thread = threadId();
+        e.phase = (uint32_t)phase;
+    }
+
+    // Prints count, mean, p50, p99 and max of every phase that recorded anything
+    void report(FILE* out) const {
+        fprintf(out, "%-10s %10s %10s %10s %10s %10s\n", "phase", "count", "mean us", "p50 us", "p99 us", "max us");
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            const LatencyHistogram& h = phases[p];
+            if (!h.count()) continue;
+            fprintf(out, "%-10s %10llu %10.1f %10.1f %10.1f %10.1f\n", phaseName(p), (unsigned long long)h.count(),
+                    h.mean() / 1000, h.percentile(0.50) / 1000.0, h.percentile(0.99) / 1000.0, h.max() / 1000.0);
+        }
+        if (droppedTraceEvents())
+            fprintf(out, "Trace buffer full: %llu events dropped\n", (unsigned long long)droppedTraceEvents());
+    }
+
+    unsigned long long droppedTraceEvents() const {
+        size_t n = traceNext.load(std::memory_order_relaxed);
+        return n > traceCapacity ? n - traceCapacity : 0;
+    }
+
+    // Writes the trace as Chrome trace_event JSON ("X" complete events, times in microseconds).
+    // Call once recording has stopped. Returns false if the file cannot be written.
+    bool writeTrace(const std::string& path) const {
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) return false;
+        size_t n = std::min(traceNext.load(std::memory_order_acquire), traceCapacity);
+        fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        for (size_t i = 0; i < n; i++) {
+            const TraceEvent& e = trace[i];
+            fprintf(f, "{\"name\": \"%s\", \"cat\": \"snake\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, "
+                       "\"ts\": %.3f, \"dur\": %.3f}%s\n",
+                    phaseName(e.phase), e.thread, e.start / 1000.0, e.duration / 1000.0, i + 1 < n ? "," : "");
+        }
+        fprintf(f, "]}\n");
+        return fclose(f) == 0;
+    }
+
+private:
+    Clock::time_point origin;           // Time zero of the trace
+    std::unique_ptr<TraceEvent[]> trace;
+    size_t traceCapacity;               // 0 = tracing off
+    std::atomic<size_t> traceNext;      // Next free trace slot; may run past the capacity
+
+    // Numbers threads 1, 2, ... in the order they first record
+    static uint32_t threadId() {
+        static std::atomic<uint32_t> nextId(1);
+        static thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+};
+
+// Records the enclosing scope as one phase. A null profiler records nothing.
+class ProfileScope {
+public:
+    ProfileScope(Profiler* profiler, int phase) : profiler(profiler), phase(phase) {
+        if (profiler) begin = profiler->now();
+    }
+    ~ProfileScope() {
+        if (profiler) profiler->record(phase, begin);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler* profiler;
+    int phase;
+    Profiler::Clock::time_point begin;
+};
@@ -0,0 +1,178 @@
+// Renderer.h
+// Double-buffered cell renderer. Front-ends draw a whole frame into the back buffer;
+// present() compares it with what is already on screen (the front buffer) and appends
+// only the changed runs as ANSI escape sequences to a string, so each frame can be sent
+// to the terminal with a single write. No I/O happens here: the caller owns the output.
+#pragma once
+
+#include <string> // For the output sink
+#include <vector> // For the cell buffers
+
+// --- Screen Cell ---
+// One character cell: a Unicode code point and a Windows-style console color (0-15)
+struct ScreenCell {
+    char32_t ch;         // Code point shown in the cell (CELL_CONTINUATION for the right half of a wide glyph)
+    unsigned char color; // Console color attribute, same numbering as setColor()
+    bool operator==(const ScreenCell& c) const { return ch == c.ch && color == c.color; }
+    bool operator!=(const ScreenCell& c) const { return !(*this == c); }
+};
+
+const char32_t CELL_CONTINUATION = 0; // Covered by the wide glyph to its left, never emitted
+const int RUN_MERGE_GAP = 4;          // Unchanged cells re-sent to avoid breaking a run with a cursor move
+
+// Maps a Windows console color (0-15) to its ANSI SGR foreground code
+inline int ansiColorCode(int color) {
+    static const int base[8] = {0, 4, 2, 6, 1, 5, 3, 7}; // Windows BGR bit order to ANSI RGB order
+    return (color & 8 ? 90 : 30) + base[color & 7];
+}
+
+// Appends a code point to a string as UTF-8
+inline void appendUtf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+// True for code points terminals draw two columns wide (the emoji used in the banners)
+inline bool isWideGlyph(char32_t cp) {
+    return cp >= 0x1F000 || (cp >= 0x2600 && cp <= 0x27BF);
+}
+
+// --- Viewport ---
+// The window of a board that is on screen. On boards larger than the screen it follows the
+// snake's head with a dead zone: the window only scrolls once the head comes within a quarter
+// of the window of an edge, so most frames still differ from the previous one in a few cells.
+struct Viewport {
+    int x = 0, y = 0;          // Board cell shown in the top-left screen cell
+    int width = 0, height = 0; // Size of the window in cells
+
+    // Resets the window to a board of boardWidth x boardHeight, at most maxWidth x maxHeight
+    void fit(int boardWidth, int boardHeight, int maxWidth, int maxHeight) {
+        width = boardWidth < maxWidth ? boardWidth : maxWidth;
+        height = boardHeight < maxHeight ? boardHeight : maxHeight;
+        x = y = 0;
+    }
+
+    // Scrolls so (headX, headY) is at least a quarter window away from every edge, without
+    // showing anything outside the board
+    void follow(int headX, int headY, int boardWidth, int boardHeight) {
+        int marginX = width / 4, marginY = height / 4;
+        if (headX < x + marginX) x = headX - marginX;
+        if (headX >= x + width - marginX) x = headX - width + marginX + 1;
+        if (headY < y + marginY) y = headY - marginY;
+        if (headY >= y + height - marginY) y = headY - height + marginY + 1;
+        if (x > boardWidth - width) x = boardWidth - width;
+        if (y > boardHeight - height) y = boardHeight - height;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+    }
+};
+
+// --- Renderer Class ---
+class Renderer {
+public:
+    int width, height;             // Size of the screen area in cells
+    std::vector<ScreenCell> back;  // Frame being drawn
+    std::vector<ScreenCell> front; // Frame currently on screen
+    bool fullRedraw;               // True if the screen contents are unknown and must all be re-sent
+
+    // Constructor: Creates blank buffers; the first present() repaints everything
+    Renderer(int width, int height) : width(width), height(height),
+        back(width * height, ScreenCell{U' ', 7}), front(width * height, ScreenCell{U' ', 7}), fullRedraw(true) {}
+
+    // Blanks the back buffer before drawing a new frame
+    void clear() {
+        for (ScreenCell& c : back) c = ScreenCell{U' ', 7};
+    }
+
+    // Draws one character into the back buffer (ignored outside the screen)
+    void put(int x, int y, char32_t ch, unsigned char color) {
+        if (x < 0 || x >= width || y < 0 || y >= height) return;
+        back[y * width + x] = ScreenCell{ch, color};
+    }
+
+    // Draws a UTF-8 string starting at (x, y); wide glyphs take two cells
+    void text(int x, int y, const std::string& utf8, unsigned char color) {
+        size_t i = 0;
+        while (i < utf8.size()) {
+            unsigned char c = (unsigned char)utf8[i];
+            char32_t cp;
+            int extra;
+            if (c < 0x80) { cp = c; extra = 0; }
+            else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+            else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+            else { cp = c & 0x07; extra = 3; }
+            for (int k = 1; k <= extra && i + k < utf8.size(); k++)
+                cp = (cp << 6) | ((unsigned char)utf8[i + k] & 0x3F);
+            i += extra + 1;
+            if (cp == 0xFE0F) continue; // Emoji presentation selector takes no cell of its own
+
+            put(x++, y, cp, color);
+            if (isWideGlyph(cp)) put(x++, y, CELL_CONTINUATION, color);
+        }
+    }
+
+    // Forces the next present() to repaint every cell (e.g. after the terminal was cleared)
+    void invalidate() { fullRedraw = true; }
+
+    // Appends the escape sequences that turn the front buffer into the back buffer to out,
+    // then makes the back buffer the new front buffer. Changed cells on a row are merged
+    // into runs; a run only moves the cursor when it starts and only changes color when needed.
+    void present(std::string& out) {
+        int currentColor = -1;   // Color last selected in the output
+        int cursorX = -1, cursorY = -1; // Where the terminal cursor is after the output so far
+        if (fullRedraw) {
+            out += "\x1b[0m\x1b[2J"; // Reset attributes and clear the screen
+        }
+
+        for (int y = 0; y < height; y++) {
+            const ScreenCell* b = &back[y * width];
+            const ScreenCell* f = &front[y * width];
+            int x = 0;
+            while (x < width) {
+                if (!fullRedraw && b[x] == f[x]) { x++; continue; }
+
+                // Extend the run over changed cells and short gaps of unchanged ones
+                int end = x + 1;
+                int lastChanged = x;
+                while (end < width && end - lastChanged <= RUN_MERGE_GAP) {
+                    if (fullRedraw || b[end] != f[end]) lastChanged = end;
+                    end++;
+                }
+                end = lastChanged + 1;
+                if (end < width && b[end].ch == CELL_CONTINUATION) end++; // Keep wide glyphs whole
+                if (b[x].ch == CELL_CONTINUATION && x > 0) x--; // Start on the wide glyph itself
+
+                if (cursorX != x || cursorY != y) {
+                    out += "\x1b[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+                }
+                for (int i = x; i < end; i++) {
+                    if (b[i].ch == CELL_CONTINUATION) continue;
+                    if (b[i].color != currentColor) {
+                        currentColor = b[i].color;
+                        out += "\x1b[" + std::to_string(ansiColorCode(currentColor)) + "m";
+                    }
+                    appendUtf8(out, b[i].ch);
+                }
+                cursorX = end;
+                cursorY = y;
+                x = end;
+            }
+        }
+
+        front = back;
+        fullRedraw = false;
+    }
+};
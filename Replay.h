@@ -0,0 +1,199 @@
+// Replay.h
+// Compact binary replays: the seed and starting level of a session plus the turn applied on
+// each tick. Because the core is deterministic for a given seed, feeding the same turns to
+// Game::step() reproduces the session exactly, at any speed.
+//
+// File layout (all integers are unsigned LEB128 varints unless noted):
+//   "SNKR"  magic (4 bytes)
+//   version (1 byte)
+//   seed, start level
+//   board width, height, fruits to clear a level (version 2 and later; version 1 files
+//   were all played on the default 70x30 board)
+//   turn records: (ticksSincePreviousRecord << 2 | directionCode), one per tick with a turn
+//   0       end marker
+//   ticks recorded after the last turn record
+//   final state hash (8 bytes, little-endian) for checking a playback against the recording
+#pragma once
+
+#include <cstdint>     // For fixed-width integers
+#include <fstream>     // For reading and writing replay files
+#include <string>      // For file paths
+#include <vector>      // For the encoded bytes
+#include "SnakeCore.h" // For Game and the direction constants
+
+#define REPLAY_VERSION 2
+
+// --- Varint Encoding ---
+
+// Appends value as an unsigned LEB128 varint (7 bits per byte, high bit = more bytes follow)
+inline void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+// Reads a varint at pos, advancing pos; returns false if the data ends early
+inline bool readVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Direction <-> 2-bit code used in turn records
+inline int directionCode(char dir) {
+    switch (dir) {
+        case DIR_UP: return 0;
+        case DIR_DOWN: return 1;
+        case DIR_LEFT: return 2;
+        default: return 3;
+    }
+}
+inline char directionFromCode(int code) {
+    static const char dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+    return dirs[code & 3];
+}
+
+// --- State Hash ---
+// FNV-1a over everything that defines the outcome of a session: level, scores, snake, food.
+// Two runs of the same replay must produce the same hash.
+inline uint64_t hashGame(const Game& game) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](uint64_t v) {
+        for (int i = 0; i < 8; i++) {
+            h ^= (v >> (i * 8)) & 0xFF;
+            h *= 1099511628211ULL;
+        }
+    };
+    const Board& board = *game.board;
+    mix(game.currentLevel);
+    mix(game.totalMoneyCollected);
+    mix(game.over);
+    mix(board.score);
+    mix(board.fruitCount);
+    mix(board.food.x);
+    mix(board.food.y);
+    mix(board.isMoneyFruit);
+    mix(board.snake->direction);
+    mix(board.snake->length);
+    mix(board.snake->pendingGrowth);
+    for (int i = 0; i < board.snake->length; i++) {
+        mix((uint32_t)board.snake->segment(i).x);
+        mix((uint32_t)board.snake->segment(i).y);
+    }
+    return h;
+}
+
+// --- Replay Recorder ---
+// Call record() with the turn passed to Game::step() on every tick, then finish().
+class ReplayRecorder {
+public:
+    std::vector<uint8_t> bytes; // Encoded replay so far
+    uint64_t ticks;             // Ticks recorded
+    uint64_t lastRecordTick;    // Tick of the previous turn record
+
+    ReplayRecorder(uint64_t seed, int startLevel, const GameConfig& config = GameConfig()) : ticks(0), lastRecordTick(0) {
+        bytes.insert(bytes.end(), {'S', 'N', 'K', 'R', REPLAY_VERSION});
+        writeVarint(bytes, seed);
+        writeVarint(bytes, (uint64_t)startLevel);
+        writeVarint(bytes, (uint64_t)config.width);
+        writeVarint(bytes, (uint64_t)config.height);
+        writeVarint(bytes, (uint64_t)config.fruitsToClearLevel);
+    }
+
+    // Records the input of one tick (DIR_NONE costs nothing)
+    void record(char turn) {
+        ticks++;
+        if (turn == DIR_NONE) return;
+        writeVarint(bytes, ((ticks - lastRecordTick) << 2) | (uint64_t)directionCode(turn));
+        lastRecordTick = ticks;
+    }
+
+    // Closes the turn log and appends the state the session ended in
+    void finish(const Game& game) {
+        writeVarint(bytes, 0);
+        writeVarint(bytes, ticks - lastRecordTick);
+        uint64_t h = hashGame(game);
+        for (int i = 0; i < 8; i++) bytes.push_back((uint8_t)(h >> (i * 8)));
+    }
+
+    // Writes the finished replay to a file; returns false on I/O failure
+    bool save(const std::string& path) const {
+        std::ofstream f(path, std::ios::binary);
+        if (!f.is_open()) return false;
+        f.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+        return (bool)f;
+    }
+};
+
+// --- Replay Player ---
+// Decodes a replay and hands back the recorded turn for each tick in order.
+class ReplayPlayer {
+public:
+    uint64_t seed = 0;         // Seed to start the Game with
+    int startLevel = 1;        // Level to start the Game at
+    GameConfig config;         // Board the session was played on
+    uint64_t totalTicks = 0;   // Ticks in the recording
+    uint64_t finalHash = 0;    // hashGame() of the recorded session's final state
+    std::vector<std::pair<uint64_t, char>> turns; // (tick, direction), ascending ticks
+    uint64_t tick = 0;         // Ticks played back so far
+    size_t nextTurn = 0;       // Index of the next entry in turns
+
+    // Loads a replay file; returns false if it is missing or malformed, or names a start level
+    // outside 1..MAX_LEVEL or a fruit goal below 1
+    bool load(const std::string& path) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) return false;
+        std::vector<uint8_t> in((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        return decode(in);
+    }
+
+    bool decode(const std::vector<uint8_t>& in) {
+        if (in.size() < 5 || in[0] != 'S' || in[1] != 'N' || in[2] != 'K' || in[3] != 'R' || in[4] < 1 ||
+            in[4] > REPLAY_VERSION)
+            return false;
+        size_t pos = 5;
+        uint64_t level, record, trailing;
+        if (!readVarint(in, pos, seed) || !readVarint(in, pos, level)) return false;
+        if (level < 1 || level > MAX_LEVEL) return false; // Replays are of the built-in levels
+        startLevel = (int)level;
+        config = GameConfig();
+        if (in[4] >= 2) {
+            uint64_t width, height, fruits;
+            if (!readVarint(in, pos, width) || !readVarint(in, pos, height) || !readVarint(in, pos, fruits)) return false;
+            if (width > MAX_BOARD_SIZE || height > MAX_BOARD_SIZE || fruits < 1 || fruits > INT32_MAX) return false;
+            config.setSize((int)width, (int)height);
+            config.fruitsToClearLevel = (int)fruits;
+        }
+
+        turns.clear();
+        uint64_t t = 0;
+        while (true) {
+            if (!readVarint(in, pos, record)) return false;
+            if (record == 0) break; // End marker
+            t += record >> 2;
+            turns.push_back({t, directionFromCode((int)(record & 3))});
+        }
+        if (!readVarint(in, pos, trailing) || pos + 8 > in.size()) return false;
+        totalTicks = t + trailing;
+        finalHash = 0;
+        for (int i = 0; i < 8; i++) finalHash |= (uint64_t)in[pos + i] << (i * 8);
+        tick = 0;
+        nextTurn = 0;
+        return true;
+    }
+
+    bool finished() const { return tick >= totalTicks; }
+
+    // Returns the turn to pass to Game::step() for the next tick
+    char next() {
+        tick++;
+        if (nextTurn < turns.size() && turns[nextTurn].first == tick) return turns[nextTurn++].second;
+        return DIR_NONE;
+    }
+};
@@ -0,0 +1,335 @@
+// ScoreStore.h
+// Persistent record of finished runs (score, money, level reached, duration, replay seed) and
+// of the last starting level, replacing the single numbers once kept in highscore.txt and
+// level.txt. The file is an append-only log of fixed-size records, each with its own CRC-32:
+// a crash during a write can only cut off the records being written, and a damaged tail is
+// dropped (and the file rewritten) the next time the store is opened.
+//
+// Appends are buffered and written SCORE_FLUSH_BYTES at a time without fsync, so a batch run
+// can record millions of games; only compaction syncs. Interactive callers flush() after each
+// write, since a program killed by a signal loses whatever is still buffered. Compaction
+// rewrites the log with just the records still live (the best `retain` runs, each level's best
+// run and the latest starting level) into a temporary file that replaces the log by rename, and
+// runs by itself once the log holds more dead records than live ones.
+//
+// The index keeps the runs in rank order, so adding a run costs O(log n), the best k runs
+// (top) come off its front in O(k), and the best run that ended on a level (bestOfLevel) is
+// one lookup in a map of levels. Runs rank by money, then score, then whichever came first.
+// The game's high score is the most money of a won run (bestWonMoney); the best won run is
+// kept through compaction like each level's best.
+//
+// File form (integers little-endian):
+//   "SNKS" magic (4 bytes), version (1 byte), 3 bytes of zero
+//   records of SCORE_RECORD_BYTES:
+//     CRC-32 of the other 36 bytes (4), type (1), flags (1: bit 0 = won), start level (2),
+//     level reached (2), zero (2), score (4), money (4), duration in ms (4), ticks (8), seed (8)
+//   A start level record (SCORE_START_LEVEL) uses only the start level field.
+// Not thread-safe: one thread owns the store.
+#pragma once
+
+#include <algorithm> // For std::sort and std::unique
+#include <cstdint>   // For the records
+#include <cstdio>    // For the log file
+#include <cstring>   // For memcmp
+#include <map>       // For the best run of each level
+#include <set>       // For the ranking
+#include <string>    // For paths
+#include <vector>    // For the write buffer
+#include "SnakeCore.h" // Game
+#include "FileIO.h"    // MappedFile, CRC-32, atomic file replacement
+
+#define SCORE_STORE_VERSION 1
+#define SCORE_HEADER_BYTES 8
+#define SCORE_RECORD_BYTES 40
+#define SCORE_FLUSH_BYTES (64 * 1024) // Appends are written in batches of this size
+#define SCORE_RETAIN_RUNS 100000      // Best runs kept by default
+#define SCORE_COMPACT_SLACK 4096      // Dead records tolerated before compacting, however few are live
+
+enum ScoreRecordType { SCORE_RUN = 1, SCORE_START_LEVEL = 2 };
+
+// --- Run Record ---
+// One finished run; seed and start level (with the board size) replay it
+struct RunRecord {
+    int score = 0;          // Game::totalScore()
+    int money = 0;          // Game::totalMoneyCollected
+    int startLevel = 1;
+    int levelReached = 1;   // Level the run ended on
+    bool won = false;
+    long long ticks = 0;    // Length in ticks
+    uint32_t durationMs = 0; // Length in wall-clock time
+    uint64_t seed = 0;      // Game seed
+    uint64_t order = 0;     // Position in the log (assigned by the store)
+
+    // Fills in a finished game
+    static RunRecord of(const Game& game, int startLevel, long long ticks, uint32_t durationMs) {
+        RunRecord r;
+        r.score = game.totalScore();
+        r.money = game.totalMoneyCollected;
+        r.startLevel = startLevel;
+        r.levelReached = game.currentLevel;
+        r.won = game.won;
+        r.ticks = ticks;
+        r.durationMs = durationMs;
+        r.seed = game.seed;
+        return r;
+    }
+};
+
+// --- Score Store ---
+class ScoreStore {
+public:
+    // Best first
+    struct Ranking {
+        bool operator()(const RunRecord& a, const RunRecord& b) const {
+            if (a.money != b.money) return a.money > b.money;
+            if (a.score != b.score) return a.score > b.score;
+            return a.order < b.order;
+        }
+    };
+
+    size_t retain = SCORE_RETAIN_RUNS; // Runs kept besides each level's best (0 = all of them)
+    long long droppedBytes = 0;        // Damaged tail found by open() and removed
+    long long compactions = 0;         // Compactions since open()
+
+    ScoreStore() {}
+    ~ScoreStore() { close(); }
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    // Loads the log at path, creating it if there is none. Returns false with a message in
+    // error if it cannot be read or written, or is not a score log.
+    bool open(const std::string& path, std::string& error) {
+        close();
+        this->path = path;
+        runs.clear();
+        levelBest.clear();
+        haveWon = false;
+        lastStartLevel = 0;
+        nextOrder = 0;
+        logRecords = 0;
+        compactions = 0;
+        MappedFile file;
+        if (file.open(path) && file.size() > 0) {
+            const uint8_t* data = (const uint8_t*)file.data();
+            if (file.size() < SCORE_HEADER_BYTES || memcmp(data, "SNKS", 4) != 0) {
+                error = path + " is not a score log";
+                return false;
+            }
+            if (data[4] > SCORE_STORE_VERSION) {
+                error = "unsupported score log version";
+                return false;
+            }
+            size_t pos = SCORE_HEADER_BYTES;
+            for (; pos + SCORE_RECORD_BYTES <= file.size(); pos += SCORE_RECORD_BYTES) {
+                if (get(data + pos, 4) != crc32(data + pos + 4, SCORE_RECORD_BYTES - 4)) break;
+                if (!apply(data + pos)) break;
+                logRecords++;
+            }
+            droppedBytes = (long long)(file.size() - pos);
+        } else {
+            droppedBytes = 0;
+        }
+        file.close();
+        // A new log, or one with a damaged tail, is written out whole before anything is appended
+        bool rewrite = logRecords == 0 || droppedBytes > 0;
+        if (rewrite ? !compact() : !(out = fopen(path.c_str(), "ab"))) {
+            error = "cannot write " + path;
+            return false;
+        }
+        compactions = 0;
+        return true;
+    }
+
+    // Writes what is buffered and closes the log
+    void close() {
+        if (!out) return;
+        flush();
+        fclose(out);
+        out = nullptr;
+    }
+
+    bool isOpen() const { return out != nullptr; }
+
+    // Records a finished run (its order is assigned here)
+    void add(RunRecord run) {
+        run.order = nextOrder++;
+        insert(run);
+        append(SCORE_RUN, run);
+    }
+
+    // Records the level the player chose to start on
+    void setStartLevel(int level) {
+        lastStartLevel = level;
+        RunRecord r;
+        r.startLevel = level;
+        append(SCORE_START_LEVEL, r);
+    }
+
+    // Last starting level recorded, or 0 if none was
+    int startLevel() const { return lastStartLevel; }
+
+    // Up to k best runs, best first
+    std::vector<RunRecord> top(size_t k) const {
+        std::vector<RunRecord> result;
+        for (auto it = runs.begin(); it != runs.end() && result.size() < k; ++it) result.push_back(*it);
+        return result;
+    }
+
+    // Most money of any run, 0 without runs
+    int bestMoney() const { return runs.empty() ? 0 : runs.begin()->money; }
+
+    // Most money of a run that cleared every level (the high score), 0 without one
+    int bestWonMoney() const { return haveWon ? bestWon.money : 0; }
+
+    // Best run that ended on the level; false if none did
+    bool bestOfLevel(int level, RunRecord& best) const {
+        auto it = levelBest.find(level);
+        if (it == levelBest.end()) return false;
+        best = it->second;
+        return true;
+    }
+
+    // Levels some run ended on, in order
+    std::vector<int> levels() const {
+        std::vector<int> result;
+        for (const auto& entry : levelBest) result.push_back(entry.first);
+        return result;
+    }
+
+    size_t runCount() const { return runs.size(); }  // Runs in the index
+    long long recordCount() const { return logRecords; } // Records in the log, live or not
+
+    // Writes the buffered records to the file (no fsync); false on I/O failure
+    bool flush() {
+        if (!out || pending.empty()) return out != nullptr;
+        bool ok = fwrite(pending.data(), 1, pending.size(), out) == pending.size() && fflush(out) == 0;
+        pending.clear();
+        return ok;
+    }
+
+    // Rewrites the log with only its live records, synced, replacing the old log by rename.
+    // Returns false on I/O failure, leaving the old log in place.
+    bool compact() {
+        std::vector<RunRecord> live(runs.begin(), runs.end());
+        for (const auto& entry : levelBest)
+            if (!kept(entry.second)) live.push_back(entry.second);
+        if (haveWon && !kept(bestWon)) live.push_back(bestWon);
+        std::sort(live.begin(), live.end(), [](const RunRecord& a, const RunRecord& b) { return a.order < b.order; });
+        // The best won run may also be its level's best
+        live.erase(std::unique(live.begin(), live.end(),
+                               [](const RunRecord& a, const RunRecord& b) { return a.order == b.order; }),
+                   live.end());
+
+        std::vector<uint8_t> bytes = {'S', 'N', 'K', 'S', SCORE_STORE_VERSION, 0, 0, 0};
+        if (lastStartLevel > 0) {
+            RunRecord r;
+            r.startLevel = lastStartLevel;
+            encode(bytes, SCORE_START_LEVEL, r);
+        }
+        for (const RunRecord& r : live) encode(bytes, SCORE_RUN, r);
+
+        if (out) {
+            fclose(out);
+            out = nullptr;
+        }
+        pending.clear();
+        bool ok = writeFileAtomically(path, bytes);
+        out = fopen(path.c_str(), "ab");
+        if (!out) return false;
+        if (ok) {
+            logRecords = (long long)((bytes.size() - SCORE_HEADER_BYTES) / SCORE_RECORD_BYTES);
+            compactions++;
+        }
+        return ok;
+    }
+
+private:
+    std::string path;
+    FILE* out = nullptr;              // Log opened for appending
+    std::vector<uint8_t> pending;     // Records not yet written
+    std::multiset<RunRecord, Ranking> runs; // The best `retain` runs
+    std::map<int, RunRecord> levelBest;     // Best run ending on each level
+    RunRecord bestWon;                      // Best won run, if haveWon
+    bool haveWon = false;
+    int lastStartLevel = 0;
+    uint64_t nextOrder = 0;
+    long long logRecords = 0;
+
+    static void put(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int b = 0; b < bytes; b++) out.push_back((uint8_t)(value >> (8 * b)));
+    }
+    static uint64_t get(const uint8_t* p, int bytes) {
+        uint64_t value = 0;
+        for (int b = 0; b < bytes; b++) value |= (uint64_t)p[b] << (8 * b);
+        return value;
+    }
+
+    static void encode(std::vector<uint8_t>& out, ScoreRecordType type, const RunRecord& r) {
+        size_t begin = out.size();
+        put(out, 0, 4); // CRC, filled in below
+        put(out, (uint64_t)type, 1);
+        put(out, r.won ? 1 : 0, 1);
+        put(out, (uint64_t)r.startLevel, 2);
+        put(out, (uint64_t)r.levelReached, 2);
+        put(out, 0, 2);
+        put(out, (uint32_t)r.score, 4);
+        put(out, (uint32_t)r.money, 4);
+        put(out, r.durationMs, 4);
+        put(out, (uint64_t)r.ticks, 8);
+        put(out, r.seed, 8);
+        uint32_t crc = crc32(out.data() + begin + 4, SCORE_RECORD_BYTES - 4);
+        for (int b = 0; b < 4; b++) out[begin + b] = (uint8_t)(crc >> (8 * b));
+    }
+
+    // Takes in one checked record from the log; false for a type this version doesn't know
+    bool apply(const uint8_t* p) {
+        RunRecord r;
+        r.won = (p[5] & 1) != 0;
+        r.startLevel = (int)get(p + 6, 2);
+        r.levelReached = (int)get(p + 8, 2);
+        r.score = (int)(int32_t)get(p + 12, 4);
+        r.money = (int)(int32_t)get(p + 16, 4);
+        r.durationMs = (uint32_t)get(p + 20, 4);
+        r.ticks = (long long)get(p + 24, 8);
+        r.seed = get(p + 32, 8);
+        if (p[4] == SCORE_START_LEVEL) {
+            lastStartLevel = r.startLevel;
+        } else if (p[4] == SCORE_RUN) {
+            r.order = nextOrder++;
+            insert(r);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Adds a run to the index, dropping the worst run past `retain`
+    void insert(const RunRecord& run) {
+        runs.insert(run);
+        if (retain > 0 && runs.size() > retain) runs.erase(std::prev(runs.end()));
+        auto best = levelBest.find(run.levelReached);
+        if (best == levelBest.end()) levelBest.emplace(run.levelReached, run);
+        else if (Ranking()(run, best->second)) best->second = run;
+        if (run.won && (!haveWon || Ranking()(run, bestWon))) {
+            bestWon = run;
+            haveWon = true;
+        }
+    }
+
+    // True if the run is among the runs the index keeps
+    bool kept(const RunRecord& run) const {
+        return !runs.empty() && !Ranking()(*std::prev(runs.end()), run);
+    }
+
+    // Buffers one record, writing the buffer when it is full and compacting when the log
+    // holds more dead records than live ones
+    void append(ScoreRecordType type, const RunRecord& r) {
+        if (!out) return; // Not opened: the index works, nothing is kept
+        encode(pending, type, r);
+        logRecords++;
+        if (pending.size() >= SCORE_FLUSH_BYTES) flush();
+        long long live = (long long)(runs.size() + levelBest.size()) + 1;
+        if (logRecords > 2 * live + SCORE_COMPACT_SLACK) compact();
+    }
+};
@@ -0,0 +1,591 @@
+// SnakeBench.cpp
+// Microbenchmarks for the engine's hot paths, with a small self-contained harness (no
+// external libraries). Each benchmark runs its operation in growing batches until a batch
+// takes at least --min-ms, and reports the time per operation of that batch. Results go to
+// stdout as a table and, with --json, to a JSON file for comparing runs over time.
+//
+// Benchmarks:
+//   snake_move    Snake::move along a Hamiltonian cycle at several snake lengths
+//   spawn_food    Board::spawnFood at several fill ratios, on levels 1 and 6 and on a large
+//                 (chunked) board
+//   board_step    one full Board::step tick, snake following a cycle and eating
+//   board_create  building a level's Board from scratch (compiled=0) and from a compiled
+//                 LevelLayout (compiled=1), on level 6 at the default and at 256x256 size
+//   flood_fill    bit-parallel floodFill() from the head over a level with 10% of its free
+//                 cells blocked, against reach_bfs, PathPlanner::bfs() over the same board
+//   dilate        one dilate() step (AVX2 when built with -mavx2), against dilate_scalar
+//   tail_reach    Board::reachableBeforeTailFrees() (timed flood fill) at several snake lengths
+//   maze_build    building one MazeGenerator candidate (difficulty 0.5), default size and 256x256
+//   maze_validate the reachability check of one candidate (bit-parallel flood fill)
+//   render_full   drawing and presenting a whole frame into a string (after invalidate())
+//   render_diff   the same for a frame that differs from the previous one by one tick
+//   compact_copy  copying a CompactState (search node clone) at several snake lengths
+//   compact_make  CompactState make() + unmake() pairs along the same cycle
+//   vecenv_step   one VecEnv::step() of a whole batch of games under random actions
+//   arena_step    one Arena tick (arena AI turns + step) on one thread, 512x512 board, at
+//                 several snake counts
+//
+// Build: g++ -O2 -std=c++17 -mavx2 -o SnakeBench SnakeBench.cpp (without -mavx2, VecEnv
+// runs its scalar path)
+// Usage: SnakeBench [--json FILE] [--filter TEXT] [--min-ms N]
+// Before the benchmarks, self-checks compare the AVX2 dilate() with the scalar one, and
+// CompactState make()/unmake() with Board::step() over random games; a mismatch is reported
+// and the run exits with status 2.
+
+#include <bits/stdc++.h> // Includes most standard libraries
+#include "SnakeCore.h"   // Platform-neutral game simulation (Point, Snake, Board, Game)
+#include "Renderer.h"    // Double-buffered ANSI cell renderer
+#include "CompactState.h" // Value-type state with make/unmake for search
+#include "VecEnv.h"       // Batch of games in structure-of-arrays form
+#include "MazeGenerator.h" // Procedural maze levels
+#include "Arena.h"         // Many snakes on one board
+#include "Autopilot.h"     // PathPlanner, the BFS the flood fills are compared with
+
+using namespace std;
+
+// --- Harness ---
+
+struct BenchResult {
+    string name;                          // Benchmark name
+    vector<pair<string, long long>> args; // Parameters, e.g. ("length", 1024)
+    long long iterations;                 // Operations in the measured batch
+    double nsPerOp;                       // Time per operation
+    double bytesPerOp;                    // Output bytes per operation (render benchmarks), else 0
+};
+
+vector<BenchResult> results;
+string filterText;        // Only benchmarks whose name contains this run
+double minSeconds = 0.2;  // Shortest batch that counts as a measurement
+volatile long long sink;  // Results are written here so the work cannot be optimised away
+
+// Runs op(n) for batches of n = 1, 10, 100, ... operations until one batch takes at least
+// minSeconds, and records the time per operation of that batch. If bytes is given, op stores
+// the output size of its batch there and the bytes per operation are recorded too.
+template <typename Op>
+void runBenchmark(const string& name, vector<pair<string, long long>> args, Op op, const size_t* bytes = nullptr) {
+    if (!filterText.empty() && name.find(filterText) == string::npos) return;
+    long long n = 1;
+    double seconds = 0;
+    while (true) {
+        auto begin = chrono::steady_clock::now();
+        op(n);
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        if (seconds >= minSeconds || n >= (1LL << 40)) break;
+        n *= seconds > 0 && minSeconds / seconds < 10 ? 2 : 10;
+    }
+    double bytesPerOp = bytes ? (double)*bytes / n : 0;
+    BenchResult r = {name, args, n, seconds * 1e9 / n, bytesPerOp};
+    results.push_back(r);
+
+    string label = name;
+    for (auto& a : args) label += " " + a.first + "=" + to_string(a.second);
+    printf("%-44s %12lld it %12.1f ns/op", label.c_str(), n, r.nsPerOp);
+    if (bytesPerOp > 0) printf(" %10.0f B/op", bytesPerOp);
+    printf("\n");
+}
+
+// Writes every result as JSON
+bool writeJson(const string& path) {
+    ofstream f(path);
+    if (!f.is_open()) return false;
+    f << "{\n  \"context\": {\"min_ms\": " << minSeconds * 1000 << ", \"board\": \"" << GameConfig().width << "x"
+      << GameConfig().height << "\"},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        f << "    {\"name\": \"" << r.name << "\", \"args\": {";
+        for (size_t j = 0; j < r.args.size(); j++)
+            f << (j ? ", " : "") << "\"" << r.args[j].first << "\": " << r.args[j].second;
+        f << "}, \"iterations\": " << r.iterations << ", \"ns_per_op\": " << fixed << setprecision(2) << r.nsPerOp;
+        if (r.bytesPerOp > 0) f << ", \"bytes_per_op\": " << setprecision(0) << r.bytesPerOp;
+        f << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+    return (bool)f;
+}
+
+// --- Fixtures ---
+
+// Direction to take from each interior cell to follow a Hamiltonian cycle of the board's
+// interior: rows are swept back and forth from column 2, and column 1 leads back up to the
+// start. Needs an even number of interior rows.
+vector<char> cycleDirections(int width, int height) {
+    vector<char> dir(width * height, DIR_NONE);
+    for (int y = 1; y <= height - 2; y++) {
+        for (int x = 1; x <= width - 2; x++) {
+            char d;
+            if (x == 1) d = y == 1 ? DIR_RIGHT : DIR_UP;
+            else if ((y - 1) % 2 == 0) d = x < width - 2 ? DIR_RIGHT : DIR_DOWN;
+            else if (y == height - 2) d = DIR_LEFT;
+            else d = x > 2 ? DIR_LEFT : DIR_DOWN;
+            dir[y * width + x] = d;
+        }
+    }
+    return dir;
+}
+
+// Grows a snake on an empty level 1 grid to the given length by following the cycle
+struct MoveFixture {
+    OccupancyGrid grid;
+    Snake snake;
+    vector<char> dirs;
+
+    MoveFixture(int width, int height, int length) : grid(*LevelLayout::builtin(1, width, height)), snake(3, 1, 1), dirs(cycleDirections(width, height)) {
+        snake.place(grid);
+        snake.pendingGrowth = length - snake.length;
+        bool ate;
+        while (snake.length < length || snake.pendingGrowth > 0) step(ate);
+    }
+
+    bool step(bool& ate) {
+        const Point& h = snake.head();
+        snake.changeDirection(dirs[h.y * grid.width + h.x]);
+        return snake.move(ate, grid);
+    }
+};
+
+// Fills a fraction of a board's free cells with snake cells, so spawnFood has less room
+void fillBoard(Board& board, double ratio, Rng& rng) {
+    long long target = (long long)(board.grid.emptyCount * ratio);
+    vector<int> cells;
+    for (int y = 0; y < board.grid.height; y++)
+        for (int x = 0; x < board.grid.width; x++)
+            if (board.grid.get(x, y) == CELL_EMPTY) cells.push_back(y * board.grid.width + x);
+    for (long long i = 0; i < target; i++) { // Partial Fisher-Yates: the first target cells are a random subset
+        swap(cells[i], cells[i + rng.below((uint32_t)(cells.size() - i))]);
+        board.grid.set(board.grid.pointAt(cells[i]), CELL_SNAKE);
+    }
+}
+
+// Draws a board the way the console front-end does: walls, food, snake
+void drawBoard(Renderer& screen, const Board& board) {
+    screen.clear();
+    for (int y = 0; y < board.grid.height; y++)
+        for (int x = 0; x < board.grid.width; x++)
+            if (board.grid.get(x, y) == CELL_WALL) screen.put(x, y, U'#', 1 + board.level);
+    if (board.hasFood) screen.put(board.food.x, board.food.y, board.isMoneyFruit ? U'$' : U'*', 10);
+    for (int i = board.snake->length - 1; i > 0; i--)
+        screen.put(board.snake->segment(i).x, board.snake->segment(i).y, U'■', 12);
+    screen.put(board.snake->head().x, board.snake->head().y, U'■', 10);
+    screen.text(board.grid.width + 2, 2, "Score: " + to_string(board.score), 11);
+}
+
+// Sets about percent of the cells of b, at random
+void randomBits(Bitboard& b, int percent, Rng& rng) {
+    b.clear();
+    for (int y = 0; y < b.height; y++)
+        for (int x = 0; x < b.width; x++)
+            if ((int)rng.below(100) < percent) b.set(x, y);
+}
+
+// --- Self-checks ---
+
+// The AVX2 dilate() against dilateScalar() on random boards, including rows that end
+// mid-word and boards too small for a whole block of four words
+bool checkDilate() {
+    Rng rng(11);
+    for (auto size : vector<pair<int, int>>{{20, 15}, {63, 17}, {64, 30}, {70, 30}, {129, 77}, {256, 256}}) {
+        Bitboard src(size.first, size.second), passable(size.first, size.second);
+        Bitboard fast(size.first, size.second), reference(size.first, size.second);
+        for (int trial = 0; trial < 20; trial++) {
+            randomBits(src, 10, rng);
+            randomBits(passable, 70, rng);
+            dilate(src, passable, fast);
+            dilateScalar(src, passable, reference);
+            if (fast != reference) {
+                cerr << "dilate() differs from dilateScalar() on a " << size.first << "x" << size.second << " board\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// True if two states hold the same snake, food, score and occupancy
+bool sameState(const CompactState& a, const CompactState& b) {
+    if (a.headX != b.headX || a.headY != b.headY || a.tailX != b.tailX || a.tailY != b.tailY || a.length != b.length ||
+        a.pendingGrowth != b.pendingGrowth || a.direction != b.direction || a.foodX != b.foodX || a.foodY != b.foodY ||
+        a.score != b.score || a.fruitCount != b.fruitCount || a.body != b.body)
+        return false;
+    for (int i = 0; i < a.length; i++)
+        if (!(a.segment(i) == b.segment(i))) return false;
+    return true;
+}
+
+// CompactState against Board: random games (mostly safe moves, often towards the food) are
+// played on both in step, comparing the events and the snake every tick; every 64 moves the
+// state takes them all back with unmake() and must come out equal to where it started
+bool checkCompactState() {
+    Rng rng(13);
+    for (int level : {1, 6}) {
+        unique_ptr<Board> board(new Board(level, 42));
+        CompactState state, start;
+        state.load(*board);
+        start = state;
+        for (int tick = 1; tick <= 20000; tick++) {
+            // Safe moves, those towards the food first; now and then any move, to die sometimes
+            const Point& h = board->snake->head();
+            int moves = board->safeMoves(), options[4] = {0, 0, 0, 0}, n = 0, closer = 0;
+            for (int d = 0; d < 4; d++) {
+                if (!(moves & (1 << d))) continue;
+                int x = h.x + AUTOPILOT_DX[d], y = h.y + AUTOPILOT_DY[d];
+                bool towards = abs(x - board->food.x) + abs(y - board->food.y) < abs(h.x - board->food.x) + abs(h.y - board->food.y);
+                if (towards) {
+                    options[n++] = options[closer];
+                    options[closer++] = d;
+                } else {
+                    options[n++] = d;
+                }
+            }
+            if (closer > 0 && rng.below(3) > 0) n = closer;
+            char dir = n > 0 && rng.below(20) > 0 ? AUTOPILOT_DIRS[options[rng.below(n)]] : AUTOPILOT_DIRS[rng.below(4)];
+            const int compared = EVENT_ATE_FOOD | EVENT_MONEY | EVENT_DIED;
+            int expected = board->step(dir) & compared, got = state.make(dir) & compared;
+            bool same = expected == got;
+            if (!(expected & EVENT_DIED)) {
+                if (board->hasFood) state.setFood(board->food.x, board->food.y);
+                const Snake& snake = *board->snake;
+                same = same && state.headX == snake.head().x && state.headY == snake.head().y && state.tailX == snake.tail().x &&
+                       state.tailY == snake.tail().y && state.length == snake.length && state.score == board->score &&
+                       state.body == board->grid.snakeBits;
+            }
+            if (!same) {
+                cerr << "CompactState differs from Board on level " << level << " at tick " << tick << "\n";
+                return false;
+            }
+            if (!(expected & EVENT_DIED) && state.depth() < 64 && tick < 20000) continue;
+            while (state.depth() > 0) state.unmake();
+            if (!sameState(state, start)) {
+                cerr << "CompactState unmake() does not restore the state on level " << level << " at tick " << tick << "\n";
+                return false;
+            }
+            if (expected & EVENT_DIED) board.reset(new Board(level, 42 + tick)); // A new game
+            state.load(*board);
+            start = state;
+        }
+    }
+    return true;
+}
+
+// --- Benchmarks ---
+
+void benchSnakeMove() {
+    // 256x256 is the largest board with dense storage; its interior cycle has 64516 cells
+    for (int length : {4, 64, 1024, 16384}) {
+        MoveFixture f(256, 256, length);
+        runBenchmark("snake_move", {{"length", length}}, [&](long long n) {
+            bool ate;
+            long long alive = 0;
+            for (long long i = 0; i < n; i++) alive += f.step(ate);
+            sink = alive;
+        });
+    }
+}
+
+void benchSpawnFood() {
+    for (int level : {1, 6}) {
+        for (int percent : {0, 50, 90, 99}) {
+            Board board(level, 42);
+            Rng rng(7);
+            fillBoard(board, percent / 100.0, rng);
+            runBenchmark("spawn_food", {{"level", level}, {"fill_pct", percent}}, [&](long long n) {
+                for (long long i = 0; i < n; i++) {
+                    board.grid.set(board.food, CELL_EMPTY); // Take the last fruit away again
+                    board.spawnFood();
+                }
+                sink = board.food.x;
+            });
+        }
+    }
+    GameConfig large; // Chunked storage, rejection sampling
+    large.setSize(1024, 1024);
+    for (int percent : {0, 50, 90}) {
+        Board board(1, 42, large);
+        Rng rng(7);
+        fillBoard(board, percent / 100.0, rng);
+        runBenchmark("spawn_food", {{"level", 1}, {"fill_pct", percent}, {"size", 1024}}, [&](long long n) {
+            for (long long i = 0; i < n; i++) {
+                board.grid.set(board.food, CELL_EMPTY);
+                board.spawnFood();
+            }
+            sink = board.food.x;
+        });
+    }
+}
+
+void benchBoardStep() {
+    GameConfig config;
+    vector<char> dirs = cycleDirections(config.width, config.height);
+    for (int level : {1}) { // The cycle covers the whole interior, so only the wall-free level fits
+        unique_ptr<Board> board;
+        // The snake starts mid-board heading right along an even row, so it is already on the cycle
+        auto reset = [&] { board.reset(new Board(level, 42, config)); };
+        reset();
+        runBenchmark("board_step", {{"level", level}}, [&](long long n) {
+            long long events = 0;
+            for (long long i = 0; i < n; i++) {
+                const Point& h = board->snake->head();
+                int e = board->step(dirs[h.y * config.width + h.x]);
+                events += e;
+                if (e & EVENT_DIED || board->snake->length > 1500) reset(); // Keep the work per tick comparable
+            }
+            sink = events;
+        });
+    }
+}
+
+void benchBoardCreate() {
+    for (int size : {0, 256}) {
+        GameConfig config;
+        if (size) config.setSize(size, size);
+        shared_ptr<const LevelLayout> layout = LevelLayout::builtin(6, config.width, config.height);
+        for (int compiled : {0, 1}) {
+            vector<pair<string, long long>> args = {{"compiled", compiled}};
+            if (size) args.push_back({"size", size});
+            runBenchmark("board_create", args, [&](long long n) {
+                long long total = 0;
+                for (long long i = 0; i < n; i++) {
+                    Board board = compiled ? Board(layout, 6, i, config) : Board(6, i, config);
+                    total += board.food.x;
+                }
+                sink = total;
+            });
+        }
+    }
+}
+
+void benchReach() {
+    for (int level : {1, 6}) {
+        Board board(level, 42);
+        Rng rng(7);
+        fillBoard(board, 0.1, rng);
+        const OccupancyGrid& grid = board.grid;
+        const Point& h = board.snake->head();
+        Bitboard open(grid.width, grid.height), seed(grid.width, grid.height), reach;
+        grid.passable(open);
+        seed.set(h.x, h.y);
+        runBenchmark("flood_fill", {{"level", level}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) {
+                floodFill(seed, open, reach);
+                total += reach.data()[reach.words / 2];
+            }
+            sink = total;
+        });
+        PathPlanner planner;
+        planner.load(board);
+        runBenchmark("reach_bfs", {{"level", level}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) total += planner.bfs(h.y * grid.width + h.x, -1);
+            sink = total;
+        });
+    }
+
+    for (int size : {0, 256}) {
+        GameConfig config;
+        if (size) config.setSize(size, size);
+        Rng rng(7);
+        Bitboard src(config.width, config.height), passable(config.width, config.height), dst(config.width, config.height);
+        randomBits(src, 10, rng);
+        randomBits(passable, 70, rng);
+        vector<pair<string, long long>> args;
+        if (size) args.push_back({"size", size});
+        runBenchmark("dilate", args, [&](long long n) {
+            for (long long i = 0; i < n; i++) dilate(src, passable, dst);
+            sink = (long long)dst.data()[dst.words / 2];
+        });
+        runBenchmark("dilate_scalar", args, [&](long long n) {
+            for (long long i = 0; i < n; i++) dilateScalar(src, passable, dst);
+            sink = (long long)dst.data()[dst.words / 2];
+        });
+    }
+
+    GameConfig config;
+    vector<char> dirs = cycleDirections(config.width, config.height);
+    for (int length : {16, 256, 1024}) {
+        Board board(1, 42, config); // Starts on the cycle, as in board_step
+        board.snake->pendingGrowth = length - board.snake->length;
+        while (board.snake->length < length || board.snake->pendingGrowth > 0) {
+            const Point& h = board.snake->head();
+            board.step(dirs[h.y * config.width + h.x]);
+        }
+        Bitboard reach;
+        runBenchmark("tail_reach", {{"length", length}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) {
+                board.reachableBeforeTailFrees(reach);
+                total += reach.data()[reach.words / 2];
+            }
+            sink = total;
+        });
+    }
+}
+
+void benchMaze() {
+    for (int size : {0, 256}) {
+        GameConfig config;
+        if (size) config.setSize(size, size);
+        MazeGenerator generator(config.width, config.height, 0.5);
+        vector<pair<string, long long>> args;
+        if (size) args.push_back({"size", size});
+        runBenchmark("maze_build", args, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) total += generator.candidate(i)->emptyCount;
+            sink = total;
+        });
+        shared_ptr<LevelLayout> layout = generator.candidate(1);
+        runBenchmark("maze_validate", args, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) total += MazeGenerator::validate(*layout);
+            sink = total;
+        });
+    }
+}
+
+void benchRender() {
+    GameConfig config;
+    for (int level : {1, 6}) {
+        Board board(level, 42, config);
+        Renderer screen(config.width + 30, config.height + 1);
+        string out;
+        size_t bytes = 0;
+
+        drawBoard(screen, board);
+        screen.present(out);
+        runBenchmark("render_full", {{"level", level}}, [&](long long n) {
+            bytes = 0;
+            for (long long i = 0; i < n; i++) {
+                out.clear();
+                drawBoard(screen, board);
+                screen.invalidate();
+                screen.present(out);
+                bytes += out.size();
+            }
+            sink = (long long)bytes;
+        }, &bytes);
+
+        // Alternate between two consecutive ticks so every frame has a real, small diff
+        Board next(level, 42, config);
+        next.step(DIR_NONE);
+        runBenchmark("render_diff", {{"level", level}}, [&](long long n) {
+            bytes = 0;
+            for (long long i = 0; i < n; i++) {
+                out.clear();
+                drawBoard(screen, (i & 1) ? board : next);
+                screen.present(out);
+                bytes += out.size();
+            }
+            sink = (long long)bytes;
+        }, &bytes);
+    }
+}
+
+void benchCompactState() {
+    GameConfig config;
+    config.setSize(256, 254); // The snake starts on an even interior row, so it is already on the cycle
+    vector<char> dirs = cycleDirections(config.width, config.height);
+    for (int length : {4, 64, 1024, 16384}) {
+        Board board(1, 42, config);
+        board.snake->pendingGrowth = length - board.snake->length; // Grow along the cycle, as in snake_move
+        while (board.snake->length < length || board.snake->pendingGrowth > 0) {
+            const Point& h = board.snake->head();
+            board.step(dirs[h.y * config.width + h.x]);
+        }
+        CompactState state, copy;
+        state.load(board);
+        copy = state;
+        runBenchmark("compact_copy", {{"length", length}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) {
+                copy = state;
+                total += copy.length;
+            }
+            sink = total;
+        });
+        // Walk 64 moves deep along the cycle and back, as a depth-first search does
+        runBenchmark("compact_make", {{"length", length}}, [&](long long n) {
+            long long events = 0;
+            for (long long i = 0; i < n; i += 64) {
+                for (int d = 0; d < 64; d++) {
+                    Point h(state.headX, state.headY);
+                    events += state.make(dirs[h.y * config.width + h.x]);
+                }
+                for (int d = 0; d < 64; d++) state.unmake();
+            }
+            sink = events;
+        });
+    }
+}
+
+void benchVecEnv() {
+    for (int games : {64, 4096}) {
+        VecEnv env(games, 1);
+        vector<uint8_t> observations((size_t)games * env.observationSize());
+        vector<float> rewards(games);
+        vector<uint8_t> dones(games);
+        env.reset(42, observations.data());
+        // Pre-drawn random turns (mostly straight on), so drawing them is not timed
+        Rng rng(7);
+        vector<int32_t> actions((size_t)games * 64);
+        for (int32_t& a : actions) a = rng.below(8) < 6 ? -1 : (int32_t)rng.below(4);
+        long long round = 0;
+        runBenchmark("vecenv_step", {{"games", games}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) {
+                env.step(&actions[(size_t)(round++ & 63) * games], rewards.data(), dones.data());
+                total += dones[0];
+            }
+            sink = total;
+        });
+    }
+}
+
+void benchArena() {
+    GameConfig config;
+    config.setSize(512, 512);
+    shared_ptr<const LevelLayout> layout = LevelLayout::builtin(1, config.width, config.height);
+    for (int snakes : {256, 4096}) {
+        Arena arena(layout, snakes, snakes / 4, 42);
+        vector<char> turns(snakes);
+        runBenchmark("arena_step", {{"snakes", snakes}}, [&](long long n) {
+            long long total = 0;
+            for (long long i = 0; i < n; i++) {
+                arena.chooseTurns(turns.data());
+                total += arena.step(turns.data());
+            }
+            sink = total;
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    string jsonPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) filterText = argv[++i];
+        else if (arg == "--min-ms" && i + 1 < argc) minSeconds = max(1, atoi(argv[++i])) / 1000.0;
+        else {
+            cerr << "Usage: " << argv[0] << " [--json FILE] [--filter TEXT] [--min-ms N]\n";
+            return 1;
+        }
+    }
+
+    if (!checkDilate() || !checkCompactState()) return 2;
+
+    benchSnakeMove();
+    benchSpawnFood();
+    benchBoardStep();
+    benchBoardCreate();
+    benchReach();
+    benchMaze();
+    benchRender();
+    benchCompactState();
+    benchVecEnv();
+    benchArena();
+
+    if (!jsonPath.empty() && !writeJson(jsonPath)) {
+        cerr << "Cannot write " << jsonPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,784 @@
+// SnakeCore.h
+// Platform-neutral simulation core for the Snake game.
+// Holds the complete game state and advances it one tick at a time through step().
+// Nothing in here touches the console, the clock or the speaker (an attached Profiler
+// only measures how long steps take), so the same code runs under the Windows console
+// front-end (SnakeGame.cpp) and the headless driver (SnakeHeadless.cpp) on any platform.
+#pragma once
+
+#include <cstdint> // For the fixed-width RNG state
+#include <memory>  // For the chunks of large boards and shared level layouts
+#include <mutex>   // For the built-in level cache
+#include <string>  // For level names and errors
+#include <vector>  // For the snake body ring buffer
+#include "Bitboard.h" // Wall and snake bit masks for whole-board queries
+#include "Profiler.h" // Optional timing of the move and spawn phases
+
+// --- Game Constants ---
+#define MAX_LEVEL 6     // Last playable level (levels 7 through 10 have been removed)
+#define MIN_BOARD_WIDTH 20   // Smallest board the level layouts fit on
+#define MIN_BOARD_HEIGHT 15
+#define MAX_BOARD_SIZE 4096  // Largest board width or height
+
+// --- Direction Constants ---
+const char DIR_NONE = 0; // No turn requested this tick
+const char DIR_UP = 'U';
+const char DIR_DOWN = 'D';
+const char DIR_LEFT = 'L';
+const char DIR_RIGHT = 'R';
+
+// --- Board Settings ---
+// Per-game settings, copied into every Board so any number of games can run side by side
+struct GameConfig {
+    int width = 70;              // Width of the game area (changed to 70)
+    int height = 30;             // Height of the game area
+    int fruitsToClearLevel = 15; // Number of fruits required to clear a level (CHANGED TO 15)
+
+    // Sets the board size, clamped to what the level layouts and the grid support
+    void setSize(int w, int h) {
+        width = w < MIN_BOARD_WIDTH ? MIN_BOARD_WIDTH : w > MAX_BOARD_SIZE ? MAX_BOARD_SIZE : w;
+        height = h < MIN_BOARD_HEIGHT ? MIN_BOARD_HEIGHT : h > MAX_BOARD_SIZE ? MAX_BOARD_SIZE : h;
+    }
+};
+
+// --- Tick Events ---
+// Bit flags returned by Board::step() and Game::step() describing what happened during one tick
+enum TickEvent {
+    EVENT_NONE = 0,
+    EVENT_ATE_FOOD = 1 << 0,      // Snake ate a fruit
+    EVENT_MONEY = 1 << 1,         // The fruit eaten was a money fruit (+$100)
+    EVENT_DIED = 1 << 2,          // Snake hit a wall or itself
+    EVENT_LEVEL_CLEARED = 1 << 3, // Enough fruits eaten to clear the level
+    EVENT_GAME_WON = 1 << 4       // The last level was cleared (reported by Game only)
+};
+
+// --- Random Number Generator ---
+// Small seedable PRNG (PCG32) owned by each game, so a seed plus the inputs reproduce a run
+// exactly on every platform. The whole state is one 64-bit word.
+class Rng {
+public:
+    uint64_t state; // Current generator state
+
+    Rng(uint64_t seed = 0) { reseed(seed); }
+
+    // Restarts the sequence for a seed (same initialisation as the PCG reference code)
+    void reseed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    // Returns the next 32 random bits
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Returns a 64-bit value (used to derive seeds)
+    uint64_t next64() {
+        uint64_t high = next();
+        return (high << 32) | next();
+    }
+
+    // Returns a uniform integer in [0, n) without modulo bias (Lemire's method)
+    uint32_t below(uint32_t n) {
+        uint64_t m = (uint64_t)next() * n;
+        uint32_t low = (uint32_t)m;
+        if (low < n) {
+            uint32_t threshold = (0u - n) % n;
+            while (low < threshold) {
+                m = (uint64_t)next() * n;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+};
+
+// --- Point Structure ---
+// Represents a coordinate (x, y) on the board
+struct Point {
+    int x, y;
+    Point(int x = 0, int y = 0) : x(x), y(y) {} // Constructor
+    // Overload == operator for easy comparison of two Point objects
+    bool operator==(const Point& p) const { return x == p.x && y == p.y; }
+};
+
+// --- Level Geometry ---
+// Returns true if (x, y) is a wall on the given level (outer border or maze pattern) of a
+// width x height board. This is the only place the built-in wall layout is defined: it is
+// evaluated once per cell when a level's LevelLayout is compiled, and boards only consult
+// the compiled layout and their occupancy grid.
+inline bool isLevelWall(int x, int y, int level, int width, int height) {
+    // Outer borders
+    if (x <= 0 || x >= width - 1 || y <= 0 || y >= height - 1) return true;
+
+    // Levels 2 and 3: vertical lines
+    if (level >= 2 && x == width / 3 && y >= 3 && y < height - 3) return true;
+    if (level >= 3 && x == 2 * width / 3 && y >= 3 && y < height - 3) return true;
+
+    if (level >= 4) {
+        // Level 4: Central Cross with Gaps
+        int center_x = width / 2;
+        int center_y = height / 2;
+        int gap_size = 5; // Size of the gap in the cross
+        if ((x == center_x && (y < center_y - gap_size || y > center_y + gap_size)) || // Vertical part
+            (y == center_y && (x < center_x - gap_size || x > center_x + gap_size))) { // Horizontal part
+            return true;
+        }
+    }
+    if (level >= 5) {
+        // Level 5: Diagonal Cross (easier - dashed lines)
+        int dash_interval = 5; // How often a wall segment appears on the diagonal
+        if ((x == y || x + y == width - 1) && (x % dash_interval == 0 || x % dash_interval == 1)) return true;
+    }
+    if (level >= 6) {
+        // Level 6: Single Vertical Barrier with Large Opening
+        int barrier_x = width / 2; // Middle of the screen
+        int opening_y_start = height / 2 - 8; // Very large opening
+        int opening_y_end = height / 2 + 8;   // Very large opening
+        if (x == barrier_x && (y < opening_y_start || y > opening_y_end)) return true;
+    }
+    // Levels 7 through 10 have been removed.
+    return false;
+}
+
+// --- Occupancy Grid ---
+// What occupies each board cell. Kept up to date incrementally (head enters, tail leaves,
+// food placed) so "is this cell free" is a single lookup.
+enum CellType : unsigned char {
+    CELL_EMPTY = 0,
+    CELL_WALL,
+    CELL_SNAKE,
+    CELL_FOOD
+};
+
+// --- Free Cell Index ---
+// Set of empty cell indices with O(1) insert, remove and uniform random pick:
+// a dense array of the cells plus a map from cell to its slot in that array.
+class FreeCellIndex {
+public:
+    std::vector<int> cells;    // Dense list of free cell indices, in no particular order
+    std::vector<int> position; // Slot of each cell in cells, or -1 if the cell is not free
+
+    FreeCellIndex(int cellCount = 0) : position(cellCount, -1) { cells.reserve(cellCount); }
+
+    int size() const { return (int)cells.size(); }
+    bool contains(int cell) const { return position[cell] >= 0; }
+
+    void insert(int cell) {
+        if (position[cell] >= 0) return;
+        position[cell] = (int)cells.size();
+        cells.push_back(cell);
+    }
+
+    // Removes a cell by moving the last entry into its slot
+    void remove(int cell) {
+        int slot = position[cell];
+        if (slot < 0) return;
+        int last = cells.back();
+        cells[slot] = last;
+        position[last] = slot;
+        cells.pop_back();
+        position[cell] = -1;
+    }
+};
+
+// --- Chunked Cells ---
+#define CHUNK_SHIFT 6                   // Chunks are 64 x 64 cells
+#define CHUNK_SIZE (1 << CHUNK_SHIFT)
+#define CHUNKED_BOARD_CELLS (256 * 256) // Boards with more cells than this use chunked storage
+
+// Sparse cell storage for large boards. The board is cut into 64x64 chunks and a chunk only
+// exists while it holds something other than empty cells, so memory follows the walls and
+// the snake rather than the board area; a chunk the snake has left is freed again.
+class ChunkedCells {
+public:
+    struct Chunk {
+        unsigned char cells[CHUNK_SIZE * CHUNK_SIZE] = {}; // CellType per cell, row-major
+        int used = 0;                                       // Cells that are not CELL_EMPTY
+    };
+
+    int chunksX = 0, chunksY = 0;               // Chunks across and down
+    std::vector<std::unique_ptr<Chunk>> chunks; // Row-major; null while a chunk is all empty
+    int allocated = 0;                          // Chunks currently in memory
+
+    void resize(int width, int height) {
+        chunksX = (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+        chunksY = (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+        chunks.clear();
+        chunks.resize((size_t)chunksX * chunksY);
+        allocated = 0;
+    }
+
+    unsigned char get(int x, int y) const {
+        const Chunk* c = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)].get();
+        return c ? c->cells[((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1))] : (unsigned char)CELL_EMPTY;
+    }
+
+    void set(int x, int y, unsigned char type) {
+        std::unique_ptr<Chunk>& c = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)];
+        if (!c) {
+            if (type == CELL_EMPTY) return;
+            c.reset(new Chunk());
+            allocated++;
+        }
+        unsigned char& cell = c->cells[((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1))];
+        c->used += (type != CELL_EMPTY) - (cell != CELL_EMPTY);
+        cell = type;
+        if (c->used == 0) {
+            c.reset();
+            allocated--;
+        }
+    }
+};
+
+// --- Level Layout ---
+// A level's geometry compiled once: every cell's type with the walls in place, the walls as a
+// bitboard and as runs per row (what a front-end draws), the free cells as a ready-made index,
+// and the snake's starting cell. A board built from a layout copies these instead of working
+// the geometry out cell by cell, and any number of boards share one layout. Layouts come from
+// the built-in levels (BuiltinLevels) or from a level pack file (LevelPack.h).
+struct LevelLayout {
+    std::string name;              // Shown by front-ends; "Level N" for the built-in levels
+    int width = 0, height = 0;     // Board size
+    int startX = 0, startY = 0;    // Head of the starting snake, which points right
+    bool chunked = false;          // Large board: no bitboard or free cell index (as OccupancyGrid)
+    long long emptyCount = 0;      // Cells that are not wall
+    std::vector<unsigned char> cells; // Row-major CELL_WALL or CELL_EMPTY per cell
+    Bitboard wallBits;             // CELL_WALL cells (standard boards)
+    FreeCellIndex freeCells;       // Every non-wall cell, in row-major order (standard boards)
+    std::vector<int> wallRuns;     // Wall runs as (x, y, length) triples, row by row
+
+    // Derives everything else from width, height and cells
+    void compile() {
+        chunked = (long long)width * height > CHUNKED_BOARD_CELLS;
+        emptyCount = 0;
+        wallRuns.clear();
+        if (!chunked) {
+            wallBits.resize(width, height);
+            freeCells = FreeCellIndex(width * height);
+        } else {
+            wallBits = Bitboard();
+            freeCells = FreeCellIndex();
+        }
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (cells[(size_t)y * width + x] != CELL_WALL) {
+                    emptyCount++;
+                    if (!chunked) freeCells.insert(y * width + x);
+                    continue;
+                }
+                if (!chunked) wallBits.set(x, y);
+                if (x > 0 && cells[(size_t)y * width + x - 1] == CELL_WALL) {
+                    wallRuns.back()++; // Extends the run of the cell to the left
+                } else {
+                    wallRuns.push_back(x);
+                    wallRuns.push_back(y);
+                    wallRuns.push_back(1);
+                }
+            }
+        }
+    }
+
+    // Compiles a built-in level for a width x height board
+    static std::shared_ptr<const LevelLayout> builtin(int level, int width, int height) {
+        std::shared_ptr<LevelLayout> layout = std::make_shared<LevelLayout>();
+        layout->name = "Level " + std::to_string(level);
+        layout->width = width;
+        layout->height = height;
+        // Levels with central obstacles start near the top-left corner: the position (3,3) is
+        // generally clear of all current maze designs
+        layout->startX = level >= 4 ? 3 : width / 2;
+        layout->startY = level >= 4 ? 3 : height / 2;
+        layout->cells.assign((size_t)width * height, CELL_EMPTY);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                if (isLevelWall(x, y, level, width, height)) layout->cells[(size_t)y * width + x] = CELL_WALL;
+        layout->compile();
+        return layout;
+    }
+};
+
+// --- Level Sources ---
+// The levels a session plays through, numbered from 1. Implementations must be safe to call
+// from several threads, as batch runs share one source between all their games.
+class LevelSource {
+public:
+    virtual ~LevelSource() {}
+    virtual int levelCount() const = 0;
+
+    // Layout of a level, possibly built on first use; nullptr if the level does not exist or
+    // cannot be built, with the reason in layoutError(level)
+    virtual std::shared_ptr<const LevelLayout> layout(int level) = 0;
+
+    // Why layout(level) returned nullptr
+    virtual std::string layoutError(int level) {
+        return "level " + std::to_string(level) + " does not exist";
+    }
+
+    // Board size of a level, without building it if the source knows it beforehand; false if
+    // the level does not exist or cannot be built
+    virtual bool boardSize(int level, int& width, int& height) {
+        std::shared_ptr<const LevelLayout> l = layout(level);
+        if (!l) return false;
+        width = l->width;
+        height = l->height;
+        return true;
+    }
+};
+
+// Levels 1 to MAX_LEVEL for one board size, each compiled the first time it is played
+class BuiltinLevels : public LevelSource {
+public:
+    BuiltinLevels(int width, int height) : width(width), height(height), layouts(MAX_LEVEL + 1) {}
+
+    int levelCount() const override { return MAX_LEVEL; }
+
+    std::shared_ptr<const LevelLayout> layout(int level) override {
+        if (level < 1 || level > MAX_LEVEL) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!layouts[level]) layouts[level] = LevelLayout::builtin(level, width, height);
+        return layouts[level];
+    }
+
+private:
+    int width, height;
+    std::mutex mutex; // Guards layouts
+    std::vector<std::shared_ptr<const LevelLayout>> layouts; // Compiled levels by number
+};
+
+class OccupancyGrid {
+public:
+    int width, height;               // Board dimensions
+    bool chunked;                    // Large board: cells live in chunks, without free index or bitboards
+    long long emptyCount;            // Number of CELL_EMPTY cells
+    std::vector<unsigned char> cells; // Row-major CellType per cell (standard boards)
+    FreeCellIndex freeCells;         // Every CELL_EMPTY cell, for uniform food spawning (standard boards)
+    Bitboard wallBits;               // CELL_WALL cells, fixed once the level is built (standard boards)
+    Bitboard snakeBits;              // CELL_SNAKE cells, kept in step by set() (standard boards)
+    ChunkedCells chunks;             // CellType per cell (large boards)
+
+    // Builds the grid for a compiled level: a copy of its cells, walls and free cells
+    explicit OccupancyGrid(const LevelLayout& layout)
+        : width(layout.width), height(layout.height), chunked(layout.chunked), emptyCount(layout.emptyCount) {
+        if (chunked) {
+            chunks.resize(width, height);
+            for (size_t i = 0; i + 2 < layout.wallRuns.size(); i += 3)
+                for (int k = 0; k < layout.wallRuns[i + 2]; k++) chunks.set(layout.wallRuns[i] + k, layout.wallRuns[i + 1], CELL_WALL);
+        } else {
+            cells = layout.cells;
+            freeCells = layout.freeCells;
+            wallBits = layout.wallBits;
+            snakeBits.resize(width, height);
+        }
+    }
+
+    // Returns what occupies (x, y); anything outside the board counts as wall
+    unsigned char get(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return CELL_WALL;
+        return chunked ? chunks.get(x, y) : cells[y * width + x];
+    }
+    unsigned char get(const Point& p) const { return get(p.x, p.y); }
+
+    // Sets the occupant of a cell on the board, keeping the free cell index in step
+    void set(const Point& p, unsigned char type) {
+        unsigned char old = get(p);
+        emptyCount += (type == CELL_EMPTY) - (old == CELL_EMPTY);
+        if (chunked) {
+            chunks.set(p.x, p.y, type);
+            return;
+        }
+        int cell = p.y * width + p.x;
+        if (type == CELL_EMPTY) freeCells.insert(cell);
+        else if (old == CELL_EMPTY) freeCells.remove(cell);
+        if (type == CELL_SNAKE) snakeBits.set(p.x, p.y);
+        else if (old == CELL_SNAKE) snakeBits.reset(p.x, p.y);
+        cells[cell] = type;
+    }
+
+    // Picks a uniformly random empty cell; returns false if there is none. Standard boards
+    // take one draw from the free cell index. Large boards draw random cells until one is
+    // empty, which needs few draws because a large board is mostly empty.
+    bool randomEmptyCell(Rng& rng, Point& out) const {
+        if (emptyCount == 0) return false;
+        if (!chunked) {
+            out = pointAt(freeCells.cells[rng.below(freeCells.size())]);
+            return true;
+        }
+        while (true) {
+            Point p(rng.below(width), rng.below(height));
+            if (chunks.get(p.x, p.y) == CELL_EMPTY) {
+                out = p;
+                return true;
+            }
+        }
+    }
+
+    // Cells the head could enter right now (empty or food); standard boards only
+    void passable(Bitboard& out) const {
+        out.fill();
+        out.andNot(wallBits);
+        out.andNot(snakeBits);
+    }
+
+    // Converts a cell index back to its coordinates
+    Point pointAt(int cell) const { return Point(cell % width, cell / width); }
+};
+
+// --- Snake Class ---
+// Manages the snake's body, movement, and direction.
+// The body lives in a circular buffer: moving writes one new head slot and releases one
+// tail slot, so a move costs the same no matter how long the snake is. The buffer doubles
+// when the snake outgrows it, so there is no length cap.
+class Snake {
+public:
+    std::vector<Point> ring; // Circular buffer of body segments (capacity is a power of two)
+    int headIndex;          // Slot of the head in ring
+    int tailIndex;          // Slot of the tail in ring
+    int length;             // Current length of the snake
+    int pendingGrowth;      // Segments still to grow: the tail stays put for this many moves
+    char direction;         // Current direction of the snake
+
+    // Constructor: Initializes snake at a starting position with initial length based on level
+    Snake(int startX, int startY, int level) {
+        length = 3 + (level - 1); // Snake starts longer in higher levels
+        int capacity = 16;
+        while (capacity < 2 * length) capacity *= 2;
+        ring.resize(capacity);
+        // Initialize snake body segments, tail first so the head ends up at the newest slot
+        for (int i = 0; i < length; i++)
+            ring[i] = Point(startX - (length - 1 - i), startY); // Snake starts horizontally
+        tailIndex = 0;
+        headIndex = length - 1;
+        pendingGrowth = 0;
+        direction = DIR_RIGHT; // Initial direction
+    }
+
+    // Returns the i-th segment counted from the head (0 = head, length - 1 = tail)
+    const Point& segment(int i) const { return ring[(headIndex - i) & (int)(ring.size() - 1)]; }
+    const Point& head() const { return ring[headIndex]; }
+    const Point& tail() const { return ring[tailIndex]; }
+
+    // Changes the snake's direction, preventing immediate 180-degree turns
+    void changeDirection(char newDir) {
+        if (newDir == DIR_UP && direction != DIR_DOWN) direction = newDir;
+        else if (newDir == DIR_DOWN && direction != DIR_UP) direction = newDir;
+        else if (newDir == DIR_LEFT && direction != DIR_RIGHT) direction = newDir;
+        else if (newDir == DIR_RIGHT && direction != DIR_LEFT) direction = newDir;
+    }
+
+    // Marks the snake's segments on the grid (segments that start off the board or inside
+    // a wall, as the long high-level snakes do, are left off until they move onto the board)
+    void place(OccupancyGrid &grid) const {
+        for (int i = 0; i < length; i++)
+            if (grid.get(segment(i)) == CELL_EMPTY) grid.set(segment(i), CELL_SNAKE);
+    }
+
+    // Moves the snake one step in its current direction, keeping the grid up to date
+    // Returns true if snake is alive, false if it collides
+    bool move(bool &ateFood, OccupancyGrid &grid) {
+        Point next = nextHead(); // Compute the new head position based on current direction
+        releaseTail(grid);
+
+        // --- Collision Detection ---
+        // Walls (outer and maze) and the snake's own body are both on the grid
+        unsigned char cell = grid.get(next);
+        if (cell == CELL_WALL || cell == CELL_SNAKE) {
+            pushHead(next); // The head ends up inside what it hit
+            return false;
+        }
+        ateFood = enter(next, grid); // Food collision: the snake grows on the next move
+        return true; // Snake is alive and moved successfully
+    }
+
+    // The parts of move(), for callers that move many snakes on one grid (Arena.h):
+
+    // Cell the head moves to next, in the current direction
+    Point nextHead() const {
+        Point next = head();
+        switch (direction) {
+            case DIR_UP: next.y--; break;
+            case DIR_DOWN: next.y++; break;
+            case DIR_LEFT: next.x--; break;
+            case DIR_RIGHT: next.x++; break;
+        }
+        return next;
+    }
+
+    // Releases the tail slot unless the snake is still growing from an earlier fruit
+    void releaseTail(OccupancyGrid &grid) {
+        if (pendingGrowth > 0) {
+            pendingGrowth--;
+            return;
+        }
+        if (grid.get(tail()) == CELL_SNAKE) grid.set(tail(), CELL_EMPTY); // Tail leaves its cell
+        tailIndex = (tailIndex + 1) & (int)(ring.size() - 1);
+        length--;
+    }
+
+    // Moves the head onto a free cell (empty or food); returns true if it ate the food there
+    bool enter(const Point &next, OccupancyGrid &grid) {
+        pushHead(next);
+        bool ateFood = grid.get(next) == CELL_FOOD;
+        if (ateFood) pendingGrowth++; // The tail stays put on the next move, growing the snake by one
+        grid.set(next, CELL_SNAKE); // Head enters its cell
+        return ateFood;
+    }
+
+private:
+    // Stores a new head segment, doubling the ring first if it is full
+    void pushHead(const Point& p) {
+        if (length == (int)ring.size()) grow();
+        headIndex = (headIndex + 1) & (int)(ring.size() - 1);
+        ring[headIndex] = p;
+        length++;
+    }
+
+    // Doubles the ring capacity, unwrapping the segments so the tail starts at slot 0
+    void grow() {
+        std::vector<Point> bigger(ring.size() * 2);
+        for (int i = 0; i < length; i++)
+            bigger[i] = segment(length - 1 - i);
+        ring.swap(bigger);
+        tailIndex = 0;
+        headIndex = length - 1;
+    }
+};
+
+// --- Board Class ---
+// Holds the state of one level: the snake, the food, the occupancy grid and the level score
+class Board {
+public:
+    Snake *snake;           // Pointer to the snake object
+    std::shared_ptr<const LevelLayout> layout; // Compiled geometry of the level
+    OccupancyGrid grid;     // Walls, snake and food per cell
+    Rng rng;                // Random source for food placement
+    Point food;             // Position of the current food item
+    bool hasFood;           // False once the snake fills every free cell
+    bool isMoneyFruit = false; // True if current food is a money fruit
+    int score, fruitCount, level; // Current score, fruits eaten in level, current level
+    int bonusMoney;         // (Not directly used, but can be for future features)
+    Point lastTail;         // Tail position before the last step (front-ends clear it when tailVacated)
+    bool tailVacated;       // True if the last step moved the tail off lastTail
+    GameConfig config;      // Size and level goal of the board
+    Profiler *profiler = nullptr; // Times the move and spawn phases of step() when set
+
+    // Constructor: Initializes board for a given built-in level
+    // and a seed for its food placement
+    Board(int level, uint64_t seed, const GameConfig& config = GameConfig())
+        : Board(LevelLayout::builtin(level, config.width, config.height), level, seed, config) {}
+
+    // Constructor: Initializes board for a compiled level layout; level is the level's number
+    // (the snake starts longer on later levels). The layout's size replaces config's.
+    Board(std::shared_ptr<const LevelLayout> levelLayout, int level, uint64_t seed, const GameConfig& config = GameConfig())
+        : layout(levelLayout), grid(*levelLayout), rng(seed), config(config) {
+        this->level = level;
+        this->config.width = layout->width;
+        this->config.height = layout->height;
+
+        snake = new Snake(layout->startX, layout->startY, level); // Create new snake at the level's start
+        snake->place(grid);
+        score = 0;
+        fruitCount = 0;
+        bonusMoney = 0;
+        lastTail = snake->tail(); // Initialize lastTail
+        tailVacated = false;
+        spawnFood(); // Place initial food
+    }
+
+    // Destructor: Cleans up dynamically allocated snake object
+    ~Board() { delete snake; }
+
+    Board(const Board&) = delete;            // Boards own their snake and are never copied
+    Board& operator=(const Board&) = delete;
+
+    // Directions the head can take next tick without hitting a wall or the body, as a bit mask
+    // (1 = up, 2 = down, 4 = left, 8 = right). The tail's cell counts as open when the tail
+    // is about to leave it.
+    int safeMoves() const {
+        const Point& t = snake->tail();
+        const Point& h = snake->head();
+        bool tailLeaves = snake->pendingGrowth == 0 && grid.get(t) == CELL_SNAKE;
+        auto open = [&](int x, int y) {
+            unsigned char c = grid.get(x, y);
+            return c == CELL_EMPTY || c == CELL_FOOD || (tailLeaves && Point(x, y) == t);
+        };
+        return (open(h.x, h.y - 1) ? 1 : 0) | (open(h.x, h.y + 1) ? 2 : 0) | (open(h.x - 1, h.y) ? 4 : 0) |
+               (open(h.x + 1, h.y) ? 8 : 0);
+    }
+
+    // Cells the head can reach if the snake keeps moving, counting each body cell as open
+    // from the tick the tail leaves it (tail first, after any pending growth). With a
+    // firstMove the snake is taken to have moved that way first (the cell must be one of
+    // safeMoves()), so the autopilot can ask where each move leads; eating food there is
+    // counted as delaying every later release by a tick, which can only leave cells out.
+    // Standard boards only: large boards keep no bitboards.
+    void reachableBeforeTailFrees(Bitboard& reach, char firstMove = DIR_NONE) const {
+        Bitboard open(grid.width, grid.height), seed(grid.width, grid.height);
+        grid.passable(open);
+        Point from = snake->head();
+        std::vector<int> release; // Body cells, tail first
+        for (int k = 0; k < snake->length - 1; k++) {
+            const Point& p = snake->segment(snake->length - 1 - k);
+            release.push_back(grid.get(p) == CELL_SNAKE ? p.y * grid.width + p.x : -1);
+        }
+        int firstRelease = snake->pendingGrowth + 1; // Step at which release[0] opens
+        if (firstMove != DIR_NONE) {
+            switch (firstMove) {
+                case DIR_UP: from.y--; break;
+                case DIR_DOWN: from.y++; break;
+                case DIR_LEFT: from.x--; break;
+                case DIR_RIGHT: from.x++; break;
+            }
+            release.push_back(snake->head().y * grid.width + snake->head().x); // The old head joins the body
+            firstRelease = snake->pendingGrowth + (grid.get(from) == CELL_FOOD ? 1 : 0);
+            if (firstRelease == 0) { // The tail left on the first move
+                if (release[0] >= 0) open.set(release[0] % grid.width, release[0] / grid.width);
+                release.erase(release.begin());
+                firstRelease = 1;
+            }
+        }
+        seed.set(from.x, from.y);
+        timedFloodFill(seed, open, release.data(), (int)release.size(), firstRelease, reach);
+    }
+
+    // Spawns a new food item on a uniformly chosen free cell
+    // Returns false, leaving the board without food, if every cell is taken
+    bool spawnFood() {
+        if (!grid.randomEmptyCell(rng, food)) {
+            hasFood = false;
+            food = Point(-1, -1);
+            return false;
+        }
+        grid.set(food, CELL_FOOD);
+        hasFood = true;
+        isMoneyFruit = ((fruitCount + 1) % 5 == 0); // Every 5th fruit is money fruit
+        return true;
+    }
+
+    // Advances the level by one tick: applies the requested turn (or DIR_NONE), moves the snake,
+    // handles eating and respawning food. Returns a combination of TickEvent flags.
+    int step(char turn) {
+        if (turn != DIR_NONE) snake->changeDirection(turn);
+
+        lastTail = snake->tail(); // Remember the tail so front-ends can clear it
+        bool ateFood = false;
+        bool alive;
+        {
+            ProfileScope timing(profiler, PHASE_MOVE);
+            alive = snake->move(ateFood, grid); // Move snake and check for collisions
+        }
+        tailVacated = !(snake->tail() == lastTail);
+
+        if (!alive) return EVENT_DIED; // Game Over if snake is not alive
+
+        int events = EVENT_NONE;
+        if (ateFood) {
+            events |= EVENT_ATE_FOOD;
+            if (isMoneyFruit) events |= EVENT_MONEY;
+            score += isMoneyFruit ? 3 : 1; // Score based on fruit type
+            fruitCount++; // Increment fruit count for current level
+            ProfileScope timing(profiler, PHASE_SPAWN);
+            spawnFood(); // Place new food
+        }
+
+        // A board with no room left for food ends the level instead of stalling
+        if (fruitCount >= config.fruitsToClearLevel || !hasFood) events |= EVENT_LEVEL_CLEARED;
+        return events;
+    }
+};
+
+// --- Game Class ---
+// A whole play session: the current level's board plus the progress carried between levels.
+// Clearing a level immediately replaces the board with the next level's board.
+class Game {
+public:
+    Board *board;            // Board of the level being played
+    int currentLevel;        // Level being played
+    int totalMoneyCollected; // Total money collected across all levels
+    int clearedScore;        // Score of the levels cleared before the current one
+    bool over;               // True once the snake died or the last level was cleared
+    bool won;                // True if the last level was cleared
+    uint64_t seed;           // Seed the session was started with
+    Rng rng;                 // Derives the seed of each level's board
+    GameConfig config;       // Settings every board of the session is built with
+    Profiler *profiler = nullptr; // Passed on to every board (set with attachProfiler)
+    LevelSource *levels;     // Levels played through; nullptr for the built-in levels
+    std::string error;       // Set (with over) if the next level could not be built; the board stays
+
+    // Constructor: Starts a session at the given level. The same seed, config, levels and
+    // sequence of step() inputs always produce the same game. With a level source the boards
+    // take their layout (and size) from it; it must outlive the session. startLevel must
+    // exist in the source and have a layout (check levels->layout(startLevel) first).
+    Game(int startLevel, uint64_t seed, const GameConfig& config = GameConfig(), LevelSource *levels = nullptr)
+        : seed(seed), rng(seed), config(config), levels(levels) {
+        currentLevel = startLevel;
+        totalMoneyCollected = 0;
+        clearedScore = 0;
+        over = false;
+        won = false;
+        board = newBoard(currentLevel);
+    }
+
+    // Destructor: Cleans up the current board
+    ~Game() { delete board; }
+
+    Game(const Game&) = delete;            // Sessions own their board and are never copied
+    Game& operator=(const Game&) = delete;
+
+    // Times the phases of this and every later board's step() with the given profiler
+    void attachProfiler(Profiler *p) {
+        profiler = p;
+        board->profiler = p;
+    }
+
+    // Advances the session by one tick. Returns the board's TickEvent flags, plus
+    // EVENT_GAME_WON when the last level is cleared. Does nothing once the game is over.
+    int step(char turn) {
+        if (over) return EVENT_NONE;
+
+        int events = board->step(turn);
+        if (events & EVENT_MONEY) totalMoneyCollected += 100; // Add bonus money
+
+        if (events & EVENT_DIED) {
+            over = true;
+        } else if (events & EVENT_LEVEL_CLEARED) {
+            if (currentLevel >= lastLevel()) {
+                // All levels completed: keep the final board for display
+                over = true;
+                won = true;
+                events |= EVENT_GAME_WON;
+            } else if (Board* next = newBoard(currentLevel + 1)) {
+                currentLevel++; // Advance to next level
+                clearedScore += board->score;
+                delete board;
+                board = next;
+                board->profiler = profiler;
+            } else {
+                // The next level cannot be built: stop here, on the cleared board
+                over = true;
+                error = levels->layoutError(currentLevel + 1);
+            }
+        }
+        return events;
+    }
+
+    // Score of the whole session so far
+    int totalScore() const { return clearedScore + board->score; }
+
+    // Number of the last level of the session
+    int lastLevel() const { return levels ? levels->levelCount() : MAX_LEVEL; }
+
+private:
+    // Board of a level; nullptr if the level source cannot build it
+    Board* newBoard(int level) {
+        if (!levels) return new Board(level, rng.next64(), config);
+        std::shared_ptr<const LevelLayout> layout = levels->layout(level);
+        return layout ? new Board(layout, level, rng.next64(), config) : nullptr;
+    }
+};
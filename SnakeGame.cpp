@@ -1,589 +1,608 @@
-#include <bits/stdc++.h> // Includes most standard libraries
-#include <conio.h>       // For _kbhit() and _getch() (console input)
-#include <windows.h>     // For Windows-specific console functions (setColor, gotoxy, Sleep, Beep)
-#include <fstream>       // For file input/output (high score, starting level)
-#include <ctime>         // For time() and clock() (random seed, game time)
-
-using namespace std;
-
-// --- Game Constants ---
-#define MAX_LENGTH 1000         // Maximum snake length
-#define WALL_CHAR '#'           // Character for drawing walls
-#define FOOD_CHAR '*'           // Character for normal food
-#define MONEY_CHAR '$'          // Character for money food
-#define SNAKE_HEAD_CHAR '\xFE'  // ASCII character for snake head (filled square)
-#define SNAKE_BODY_CHAR '\xFE'  // ASCII character for snake body (filled square)
-
-// --- Direction Constants ---
-const char DIR_UP = 'U';
-const char DIR_DOWN = 'D';
-const char DIR_LEFT = 'L';
-const char DIR_RIGHT = 'R';
-
-// --- Global Game State Variables ---
-int consoleWidth = 70;      // Width of the game area (changed to 70)
-int consoleHeight = 30;     // Height of the game area
-bool isPaused = false;      // Flag to check if the game is paused
-int fruitsToClearLevel = 15; // Number of fruits required to clear a level (CHANGED TO 15)
-int totalMoneyCollected = 0; // Total money collected across all levels
-int highScore = 0;          // Stores the highest score achieved
-int startTime;              // Stores the starting time of the current game session
-
-// --- Console Utility Functions ---
-
-// Sets the console text color
-void setColor(int color) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
-}
-
-// Moves the console cursor to a specific (x, y) coordinate
-void gotoxy(int x, int y) {
-    COORD coord = {(SHORT)x, (SHORT)y};
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
-}
-
-// Hides the blinking console cursor
-void hideCursor() {
-    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_CURSOR_INFO cursorInfo;
-    GetConsoleCursorInfo(out, &cursorInfo);
-    cursorInfo.bVisible = false; // Set cursor visibility to false
-    SetConsoleCursorInfo(out, &cursorInfo);
-}
-
-// Calculates game speed based on the current level
-// All levels will now have the same speed as Level 1
-int getSpeedForLevel(int level) {
-    return 250; // Speed for Level 1 (250 - (1-1)*50 = 250)
-}
-
-// Plays a simple beep sound for eating food
-void playEatSound() {
-    Beep(800, 150); // Frequency 800Hz, Duration 150ms
-}
-
-// --- Point Structure ---
-// Represents a coordinate (x, y) on the console
-struct Point {
-    int x, y;
-    Point(int x = 0, int y = 0) : x(x), y(y) {} // Constructor
-    // Overload == operator for easy comparison of two Point objects
-    bool operator==(const Point& p) const { return x == p.x && y == p.y; }
-};
-
-// --- Snake Class ---
-// Manages the snake's body, movement, and direction
-class Snake {
-public:
-    Point body[MAX_LENGTH]; // Array to store snake body segments
-    int length;             // Current length of the snake
-    char direction;         // Current direction of the snake
-
-    // Constructor: Initializes snake at a starting position with initial length based on level
-    Snake(int startX, int startY, int level) {
-        length = 3 + (level - 1); // Snake starts longer in higher levels
-        if (length > MAX_LENGTH) length = MAX_LENGTH; // Cap length at MAX_LENGTH
-        // Initialize snake body segments
-        for (int i = 0; i < length; i++)
-            body[i] = Point(startX - i, startY); // Snake starts horizontally
-        direction = DIR_RIGHT; // Initial direction
-    }
-
-    // Changes the snake's direction, preventing immediate 180-degree turns
-    void changeDirection(char newDir) {
-        if (newDir == DIR_UP && direction != DIR_DOWN) direction = newDir;
-        else if (newDir == DIR_DOWN && direction != DIR_UP) direction = newDir;
-        else if (newDir == DIR_LEFT && direction != DIR_RIGHT) direction = newDir;
-        else if (newDir == DIR_RIGHT && direction != DIR_LEFT) direction = newDir;
-    }
-
-    // Moves the snake one step in its current direction
-    // Returns true if snake is alive, false if it collides
-    bool move(bool &ateFood, Point food, int level) {
-        // Shift body segments: each segment takes the position of the one in front of it
-        for (int i = length - 1; i > 0; i--)
-            body[i] = body[i - 1];
-
-        // Move the head based on current direction
-        switch (direction) {
-            case DIR_UP: body[0].y--; break;
-            case DIR_DOWN: body[0].y++; break;
-            case DIR_LEFT: body[0].x--; break;
-            case DIR_RIGHT: body[0].x++; break;
-        }
-
-        // --- Collision Detection ---
-
-        // Self-collision: Check if head collides with any part of its body
-        for (int i = 1; i < length; i++)
-            if (body[0] == body[i]) return false;
-
-        // Wall collision: Check if head hits the outer borders
-        if (body[0].x <= 0 || body[0].x >= consoleWidth - 1 ||
-            body[0].y <= 0 || body[0].y >= consoleHeight - 1)
-            return false;
-
-        // Maze Wall Collision for Levels 2 and 3 (vertical lines)
-        if (level >= 2 && body[0].x == consoleWidth / 3 && body[0].y >= 3 && body[0].y < consoleHeight - 3) return false;
-        if (level >= 3 && body[0].x == 2 * consoleWidth / 3 && body[0].y >= 3 && body[0].y < consoleHeight - 3) return false;
-
-        // Maze Wall Collision for Levels 4-6 (unique patterns)
-        if (level >= 4) {
-            // Level 4: Central Cross with Gaps
-            int center_x = consoleWidth / 2;
-            int center_y = consoleHeight / 2;
-            int gap_size = 5; // Size of the gap in the cross
-            if ((body[0].x == center_x && (body[0].y < center_y - gap_size || body[0].y > center_y + gap_size)) || // Vertical part
-                (body[0].y == center_y && (body[0].x < center_x - gap_size || body[0].x > center_x + gap_size))) { // Horizontal part
-                return false;
-            }
-        }
-        if (level >= 5) {
-            // Level 5: Diagonal Cross (easier - dashed lines)
-            int dash_interval = 5; // How often a wall segment appears on the diagonal
-            if (((body[0].x == body[0].y || body[0].x + body[0].y == consoleWidth - 1) && (body[0].x % dash_interval == 0 || body[0].x % dash_interval == 1))) {
-                return false;
-            }
-        }
-        if (level >= 6) {
-            // Level 6: Single Vertical Barrier with Large Opening
-            int barrier_x = consoleWidth / 2; // Middle of the screen
-            int opening_y_start = consoleHeight / 2 - 8; // Very large opening
-            int opening_y_end = consoleHeight / 2 + 8;   // Very large opening
-
-            if (body[0].x == barrier_x && (body[0].y < opening_y_start || body[0].y > opening_y_end)) {
-                return false;
-            }
-        }
-
-        // Food collision: Check if snake head is on the food
-        ateFood = (body[0] == food);
-        if (ateFood && length < MAX_LENGTH) {
-            // If food eaten, increase snake length by adding a new segment at the tail's last position
-            body[length] = body[length - 1];
-            length++;
-        }
-        return true; // Snake is alive and moved successfully
-    }
-};
-
-// --- Board Class ---
-// Manages the game board, food, score, and drawing
-class Board {
-public:
-    Snake *snake;           // Pointer to the snake object
-    Point food;             // Position of the current food item
-    bool isMoneyFruit = false; // True if current food is a money fruit
-    int score, fruitCount, level; // Current score, fruits eaten in level, current level
-    int bonusMoney;         // (Not directly used, but can be for future features)
-    Point lastTail;         // Stores the position of the snake's tail before it moves (for clearing)
-    bool speedBoostRequested; // New: Flag to indicate if speed boost is requested
-
-    // Constructor: Initializes board for a given level
-    Board(int level) {
-        this->level = level;
-        int startX = consoleWidth / 2;
-        int startY = consoleHeight / 2;
-
-        // Adjust starting position for levels with central obstacles
-        // The position (3,3) is chosen as it is generally clear of all current maze designs.
-        if (level >= 4) {
-            startX = 3; // Start near the top-left corner
-            startY = 3; // Start near the top-left corner
-        }
-
-        snake = new Snake(startX, startY, level); // Create new snake with adjusted start
-        score = 0;
-        fruitCount = 0;
-        bonusMoney = 0;
-        lastTail = snake->body[snake->length - 1]; // Initialize lastTail
-        spawnFood(); // Place initial food
-        speedBoostRequested = false; // Initialize speed boost flag
-    }
-
-    // Destructor: Cleans up dynamically allocated snake object
-    ~Board() { delete snake; }
-
-    // Gets a wall color based on the level for visual variety
-    int getWallColor() {
-        int colors[] = {1, 2, 3, 4, 5, 6, 9, 10, 11, 13}; // Array of console colors
-        return colors[(level - 1) % 10]; // Cycle through colors based on level
-    }
-
-    // Draws the game borders and level-specific maze patterns
-    void drawBorders() {
-        setColor(getWallColor()); // Set color for walls
-
-        // Draw outer borders
-        for (int x = 0; x < consoleWidth; x++) {
-            gotoxy(x, 0); cout << WALL_CHAR; // Top border
-            gotoxy(x, consoleHeight - 1); cout << WALL_CHAR; // Bottom border
-        }
-        for (int y = 0; y < consoleHeight; y++) {
-            gotoxy(0, y); cout << WALL_CHAR; // Left border
-            gotoxy(consoleWidth - 1, y); cout << WALL_CHAR; // Right border
-        }
-
-        // Level-specific maze patterns
-        if (level >= 2) {
-            // Level 2: First vertical wall
-            for (int y = 3; y < consoleHeight - 3; y++) {
-                gotoxy(consoleWidth / 3, y); cout << WALL_CHAR;
-            }
-        }
-        if (level >= 3) {
-            // Level 3: Second vertical wall
-            for (int y = 3; y < consoleHeight - 3; y++) {
-                gotoxy(2 * consoleWidth / 3, y); cout << WALL_CHAR;
-            }
-        }
-        if (level >= 4) {
-            // Level 4: Central Cross with Gaps
-            int center_x = consoleWidth / 2;
-            int center_y = consoleHeight / 2;
-            int gap_size = 5; // Size of the gap in the cross
-            for (int x = 1; x < consoleWidth - 1; x++) {
-                if (x < center_x - gap_size || x > center_x + gap_size) {
-                    gotoxy(x, center_y); cout << WALL_CHAR;
-                }
-            }
-            for (int y = 1; y < consoleHeight - 1; y++) {
-                if (y < center_y - gap_size || y > center_y + gap_size) {
-                    gotoxy(center_x, y); cout << WALL_CHAR;
-                }
-            }
-        }
-        if (level >= 5) {
-            // Level 5: Diagonal Cross (easier - dashed lines)
-            int dash_interval = 5; // How often a wall segment appears on the diagonal
-            for (int i = 1; i < consoleWidth - 1; i++) {
-                if (i < consoleHeight - 1) {
-                    if (i % dash_interval == 0 || i % dash_interval == 1) { // Draw two characters for a dash
-                        gotoxy(i, i); cout << WALL_CHAR; // Top-left to bottom-right
-                    }
-                }
-                if (consoleWidth - 1 - i > 0 && i < consoleHeight - 1) {
-                    if (i % dash_interval == 0 || i % dash_interval == 1) { // Draw two characters for a dash
-                        gotoxy(consoleWidth - 1 - i, i); cout << WALL_CHAR; // Top-right to bottom-left
-                    }
-                }
-            }
-        }
-        if (level >= 6) {
-            // Level 6: Single Vertical Barrier with Large Opening
-            int barrier_x = consoleWidth / 2; // Middle of the screen
-            int opening_y_start = consoleHeight / 2 - 8; // Very large opening
-            int opening_y_end = consoleHeight / 2 + 8;   // Very large opening
-
-            for (int y = 1; y < consoleHeight - 1; y++) {
-                if (y < opening_y_start || y > opening_y_end) {
-                    gotoxy(barrier_x, y); cout << WALL_CHAR;
-                }
-            }
-        }
-        // Levels 7 through 10 have been removed.
-
-        setColor(7); // Reset color to default white
-    }
-
-    // Spawns a new food item at a random valid location
-    void spawnFood() {
-        while (true) {
-            int x = 1 + rand() % (consoleWidth - 2); // Random X within borders
-            int y = 1 + rand() % (consoleHeight - 2); // Random Y within borders
-
-            // Check if food spawns on any wall (outer or maze walls)
-            // This logic mirrors the collision detection in Snake::move()
-            bool collisionWithWall = false;
-
-            // Levels 2 and 3 walls
-            if ((level >= 2 && x == consoleWidth / 3 && y >= 3 && y < consoleHeight - 3) ||
-                (level >= 3 && x == 2 * consoleWidth / 3 && y >= 3 && y < consoleHeight - 3)) {
-                collisionWithWall = true;
-            }
-
-            // Maze Wall Collision for Levels 4-6 (unique patterns)
-            if (!collisionWithWall && level >= 4) {
-                // Level 4: Central Cross with Gaps
-                int center_x = consoleWidth / 2;
-                int center_y = consoleHeight / 2;
-                int gap_size = 5;
-                if ((x == center_x && (y < center_y - gap_size || y > center_y + gap_size)) ||
-                    (y == center_y && (x < center_x - gap_size || x > center_x + gap_size))) {
-                    collisionWithWall = true;
-                }
-            }
-            if (!collisionWithWall && level >= 5) {
-                // Level 5: Diagonal Cross (easier - dashed lines)
-                int dash_interval = 5;
-                if (((x == y || x + y == consoleWidth - 1) && (x % dash_interval == 0 || x % dash_interval == 1))) {
-                    collisionWithWall = true;
-                }
-            }
-            if (!collisionWithWall && level >= 6) {
-                // Level 6: Single Vertical Barrier with Large Opening
-                int barrier_x = consoleWidth / 2;
-                int opening_y_start = consoleHeight / 2 - 8;
-                int opening_y_end = consoleHeight / 2 + 8;
-
-                if (x == barrier_x && (y < opening_y_start || y > opening_y_end)) {
-                    collisionWithWall = true;
-                }
-            }
-            // Levels 7 through 10 have been removed.
-
-            if (collisionWithWall) continue; // If collision, try new coordinates
-
-            // Check if food spawns on the snake's body
-            bool onSnake = false;
-            for (int i = 0; i < snake->length; i++) {
-                if (snake->body[i].x == x && snake->body[i].y == y) {
-                    onSnake = true;
-                    break;
-                }
-            }
-            if (!onSnake) {
-                food = Point(x, y); // Valid position found
-                isMoneyFruit = ((fruitCount + 1) % 5 == 0); // Every 5th fruit is money fruit
-                break;
-            }
-        }
-    }
-
-    // Draws the food item on the console
-    void drawFood() {
-        gotoxy(food.x, food.y);
-        setColor(isMoneyFruit ? 14 : 10); // Yellow for money, green for normal
-        cout << (isMoneyFruit ? MONEY_CHAR : FOOD_CHAR);
-        setColor(7); // Reset color
-    }
-
-    // Draws the snake on the console, clearing its old tail position
-    void drawSnake() {
-        gotoxy(lastTail.x, lastTail.y);
-        cout << ' '; // Clear the old tail position
-        gotoxy(snake->body[0].x, snake->body[0].y);
-        setColor(10); // Green for head
-        cout << SNAKE_HEAD_CHAR;
-        if (snake->length > 1) {
-            gotoxy(snake->body[1].x, snake->body[1].y);
-            setColor(12); // Red for body
-            cout << SNAKE_BODY_CHAR;
-        }
-        setColor(7); // Reset color
-        lastTail = snake->body[snake->length - 1]; // Update lastTail for next frame
-    }
-
-    // Draws the score, level, fruit count, money, high score, and time on the side
-    void drawScore() {
-        // Adjusted column for UI elements due to increased console width
-        gotoxy(consoleWidth + 2, 2); setColor(11); // Cyan color
-        cout << "Level: " << level << "   "; // Added spaces to clear previous longer numbers
-        gotoxy(consoleWidth + 2, 3); cout << "Score: " << score << "   ";
-        gotoxy(consoleWidth + 2, 4); cout << "Fruits: " << fruitCount << "/" << fruitsToClearLevel << "   ";
-        gotoxy(consoleWidth + 2, 5); cout << "Money: $" << totalMoneyCollected << "   ";
-        gotoxy(consoleWidth + 2, 6); cout << "High Score: " << highScore << "   ";
-        gotoxy(consoleWidth + 2, 7); cout << "Time: " << (clock() - startTime) / CLOCKS_PER_SEC << "s   ";
-        setColor(7); // Reset color
-    }
-
-    // Updates the game state (snake movement, food eating, level progression)
-    // Returns -1 for game over, 1 for level clear, 0 for ongoing
-    int update() {
-        bool ateFood = false;
-        bool alive = snake->move(ateFood, food, level); // Move snake and check for collisions
-
-        if (!alive) return -1; // Game Over if snake is not alive
-
-        if (ateFood) {
-            score += isMoneyFruit ? 3 : 1; // Score based on fruit type
-            fruitCount++; // Increment fruit count for current level
-            if (isMoneyFruit) {
-                totalMoneyCollected += 100; // Add bonus money
-                gotoxy(10, consoleHeight);
-                setColor(14); // Yellow color
-                cout << "  Bonus Collected! +$100  "; // Display bonus message
-                setColor(7);
-                Sleep(1000); // Pause briefly to show message
-            }
-            spawnFood(); // Place new food
-            playEatSound(); // Play sound
-        }
-
-        drawSnake(); // Redraw snake
-        drawFood();  // Redraw food
-        drawScore(); // Update score display
-
-        if (fruitCount >= fruitsToClearLevel) {
-            // Level cleared logic
-            gotoxy(10, consoleHeight);
-            setColor(14);
-            cout << " 🎉 Level Cleared!    ";
-            setColor(7);
-            Sleep(1500);
-            return 1; // Indicate level cleared
-        }
-        return 0; // Game is ongoing
-    }
-
-    // Handles user input for snake direction and pause/resume
-    void getInput() {
-        speedBoostRequested = false; // Reset boost flag at the start of each input check
-        if (_kbhit()) { // Check if a key has been pressed
-            int key = _getch(); // Get the pressed key
-            if (key == 224) key = _getch(); // Handle arrow keys (they send two scan codes)
-
-            // Change snake direction based on input
-            if (key == 72 || key == 'w' || key == 'W') snake->changeDirection(DIR_UP);
-            else if (key == 80 || key == 's' || key == 'S') snake->changeDirection(DIR_DOWN);
-            else if (key == 75 || key == 'a' || key == 'A') { // Left Arrow or 'a'
-                snake->changeDirection(DIR_LEFT);
-                speedBoostRequested = true; // Request speed boost
-            }
-            else if (key == 77 || key == 'd' || key == 'D') { // Right Arrow or 'd'
-                snake->changeDirection(DIR_RIGHT);
-                speedBoostRequested = true; // Request speed boost
-            }
-            else if (key == 'p' || key == 'P') {
-                isPaused = !isPaused; // Toggle pause state
-                if (!isPaused) {
-                    gotoxy(10, 10);
-                    cout << "                                  "; // Clear pause message when unpaused
-                }
-            }
-        }
-    }
-};
-
-// --- Game Management Functions ---
-
-// Displays game instructions and prompts for starting level
-void showInstructions() {
-    system("cls"); // Clear console screen
-    setColor(11); // Cyan color
-    cout << "=============== Snake Game ===============\n";
-    cout << "Use W A S D or Arrow Keys to move the snake.\n";
-    cout << "Hold LEFT/RIGHT arrow or 'A'/'D' for 2x speed!\n"; // Added instruction
-    cout << "* = Normal fruit, $ = Money fruit (+$100)\n";
-    cout << "Eat 15 fruits to complete a level.\n"; // Updated instruction
-    cout << "Walls appear from level 2 onwards.\n";
-    cout << "Press 'P' to pause/resume.\n";
-    cout << "==========================================\n";
-    setColor(14); // Yellow color
-    cout << "Enter Starting Level (1-6): "; // Changed input range to 1-6
-    int level;
-    cin >> level; // Get user input for starting level
-    // Validate input, default to 1 if invalid
-    if (level < 1 || level > 6) level = 1; // Changed validation to 1-6
-    // Save starting level to a file (for persistence across runs)
-    ofstream f("level.txt");
-    if (f.is_open()) {
-        f << level;
-        f.close();
-    }
-    setColor(7); // Reset color
-    cout << "Press any key to start...\n";
-    _getch(); // Wait for any key press
-}
-
-// Loads the high score from a file
-void loadHighScore() {
-    ifstream f("highscore.txt");
-    if (f.is_open()) {
-        f >> highScore; // Read high score if file exists
-        f.close();
-    }
-}
-
-// Saves the current high score to a file
-void saveHighScore() {
-    ofstream f("highscore.txt");
-    if (f.is_open()) {
-        f << highScore; // Write high score
-        f.close();
-    }
-}
-
-// --- Main Game Loop ---
-int main() {
-    srand(time(0)); // Seed random number generator with current time
-    hideCursor();   // Hide the console cursor for a cleaner look
-
-    showInstructions(); // Display instructions and get starting level
-
-    int currentLevel = 1;
-    // Load starting level from file if it exists (persists last played level)
-    ifstream f_level("level.txt");
-    if (f_level.is_open()) {
-        f_level >> currentLevel;
-        f_level.close();
-    }
-
-    loadHighScore(); // Load the high score
-
-    startTime = clock(); // Record the start time of the game
-
-    // Main game loop: continues as long as the user doesn't exit
-    while (true) {
-        int base_speed = getSpeedForLevel(currentLevel); // Get base speed (always 250)
-        Board* board = new Board(currentLevel);     // Create a new game board for the level
-
-        system("cls"); // Clear the console for the new level
-        board->drawBorders(); // Draw the borders and maze for the current level
-
-        // Inner game loop: runs until game over or level cleared
-        while (true) {
-            board->getInput(); // Process user input and set speedBoostRequested flag
-
-            if (!isPaused) {
-                int effective_speed = base_speed;
-                if (board->speedBoostRequested) {
-                    effective_speed = base_speed / 2; // Double speed (half sleep time)
-                    if (effective_speed < 50) effective_speed = 50; // Ensure a minimum speed (e.g., 50ms)
-                }
-
-                int state = board->update(); // Update game state
-
-                if (state == -1) { // Game Over
-                    system("cls");
-                    gotoxy(10, 10); setColor(12); cout << "💀 GAME OVER!         "; // Red color
-                    gotoxy(10, 11); cout << "Total Money Earned: $" << totalMoneyCollected << "      ";
-                    gotoxy(10, 12); cout << "Restarting from Level 1...";
-                    setColor(7);
-                    Sleep(3000); // Pause for 3 seconds
-                    currentLevel = 1; // Reset to level 1
-                    totalMoneyCollected = 0; // Reset money
-                    startTime = clock(); // Reset game timer
-                    break; // Exit inner loop to start new game
-                } else if (state == 1) { // Level Cleared
-                    gotoxy(10, 10); setColor(10); cout << "✅ LEVEL " << currentLevel << " CLEARED!     "; // Green color
-                    setColor(7); Sleep(1500);
-                    currentLevel++; // Advance to next level
-                    if (currentLevel > 6) { // Changed max level to 6
-                        // All levels completed
-                        system("cls"); // Clear screen for final message
-                        gotoxy(consoleWidth / 2 - 15, consoleHeight / 2 - 2); setColor(11); cout << "🏆 CONGRATULATIONS! All levels complete.";
-                        gotoxy(consoleWidth / 2 - 15, consoleHeight / 2 - 1); cout << "💰 Total Money Earned: $" << totalMoneyCollected;
-                        setColor(7); Sleep(4000); // Pause for 4 seconds
-                        if (totalMoneyCollected > highScore) { // Update high score if current money is higher
-                            highScore = totalMoneyCollected;
-                            saveHighScore();
-                        }
-                        return 0; // Exit program if all levels are done
-                    }
-                    break; // Exit inner loop to start next level
-                }
-                Sleep(effective_speed); // Use the calculated effective speed
-            } else {
-                // Game is paused
-                gotoxy(10, 10); setColor(14);
-                cout << "= PAUSED == Press 'P' to resume =";
-                setColor(7);
-                Sleep(100); // Short sleep to prevent busy-waiting
-            }
-        }
-        delete board; // Clean up board object before starting a new level/game
-    }
-
-    return 0; // Program exits
-}
+#include <bits/stdc++.h> // Includes most standard libraries
+#include <ctime>         // For time() (random seed)
+#include "SnakeCore.h"   // Platform-neutral game simulation (Point, Snake, Board, Game)
+#include "Renderer.h"    // Double-buffered ANSI cell renderer
+#include "Console.h"     // Terminal setup, keyboard and speaker for Windows and POSIX
+#include "TickScheduler.h" // Fixed-timestep game clock
+#include "InputThread.h" // Keyboard reader thread feeding a lock-free command queue
+#include "Replay.h"      // Replay recording
+#include "Autopilot.h"   // Built-in AI player (--autopilot)
+#include "Profiler.h"    // Per-phase latency histograms and trace export
+#include "TimerWheel.h"  // Timed overlays and banner sequences
+#include "SoundEngine.h" // Background mixer thread for the game sounds
+#include "LevelPack.h"   // Levels loaded from a file (--levels)
+#include "ScoreStore.h"  // Log of finished runs (high score, starting level)
+#include "Snapshot.h"    // Saved session, resumed on the next start
+
+using namespace std;
+
+// --- Display Constants ---
+#define WALL_CHAR U'#'           // Character for drawing walls
+#define FOOD_CHAR U'*'           // Character for normal food
+#define MONEY_CHAR U'$'          // Character for money food
+#define SNAKE_HEAD_CHAR U'\u25A0' // Filled square for snake head
+#define SNAKE_BODY_CHAR U'\u25A0' // Filled square for snake body
+#define PANEL_WIDTH 30           // Columns to the right of the board for the score panel
+#define VIEW_WIDTH 70            // Largest part of the board shown at once (default --view)
+#define VIEW_HEIGHT 30
+#define SOUND_SAMPLE_RATE 22050  // PCM rate of --sound-file recordings
+#define TRACE_CAPACITY (1 << 20) // Phases kept for --trace (hours of play at 250 ms ticks)
+
+// --- Speaker Sink ---
+// Sends each sound to the console speaker (Beep on Windows, the terminal bell elsewhere).
+// The speaker blocks for the length of the tone, but on the mixer thread, not the game's.
+class ConsoleBeepSink : public SoundSink {
+public:
+    bool wantsPcm() const override { return false; }
+    void play(const SoundEvent& e) override { consoleBeep(e.frequency, e.durationMs); }
+};
+
+// --- Overlays ---
+// A banner drawn over the game for a while ("Bonus Collected!", "Level Cleared", game over).
+// The loop keeps ticking while it is up; one that holds the game stops the simulation (but not
+// input, drawing or the tick clock) until it is gone.
+struct Overlay {
+    uint64_t id;                        // Identifies the overlay to the timer that removes it
+    vector<pair<string, int>> lines;    // Text and color of each line
+    int x, y;                           // Screen position of the first line
+    bool fullScreen;                    // Clears the screen before drawing the lines
+    bool holdsGame;                     // Stops the simulation while shown
+};
+
+// --- Front-End State ---
+// Everything the console session keeps besides the Game itself. One instance lives in main()
+// and is passed to the drawing and input functions, so nothing about a game is global.
+struct FrontEnd {
+    GameConfig config;          // Board size and level goal of every game in the session
+    bool isPaused = false;      // Flag to check if the game is paused
+    bool quitRequested = false; // Set by the quit key; main() ends after the current tick
+    int highScore = 0;          // Stores the highest score achieved
+    ScoreStore scores;          // Every finished run and the last starting level (--scores)
+    int baseTickMs = 250;       // Tick length in milliseconds (--tick-ms)
+    TickScheduler::Clock::time_point startTime; // Stores the starting time of the current game session
+    TickScheduler scheduler;    // Paces the game loop; also tracks late ticks
+    Viewport view;              // Part of the board on screen (all of it unless the board is large)
+    int viewBoardWidth, viewBoardHeight; // Board size view was fitted to
+    Renderer screen;            // Board window, score panel and message line
+    Profiler profiler;          // Time spent in each phase of a tick
+    TimerWheel timers;          // Removes overlays when their time is up; advanced once per loop
+    vector<Overlay> overlays;   // Overlays on screen, drawn over the frame in this order
+    uint64_t nextOverlayId = 1;
+    TickScheduler::Clock::time_point clockOrigin = TickScheduler::Clock::now(); // Time zero of the timers
+    unique_ptr<SoundEngine> sound; // Plays the sounds off the game thread
+    string tracePath;           // Chrome trace of every phase is written here on exit (--trace)
+    string savePath;            // A session quit with 'Q' is saved here and resumed on the next start (--save)
+    unique_ptr<LevelSource> levels; // Built-in levels or the --levels pack, compiled once per run
+
+    // The screen fits a config-sized board; boards of other sizes (from a level pack) are
+    // shown through a view refitted to that screen
+    FrontEnd(const GameConfig& config, int viewWidth, int viewHeight)
+        : config(config), view(makeView(config, viewWidth, viewHeight)), viewBoardWidth(config.width),
+          viewBoardHeight(config.height), screen(view.width + PANEL_WIDTH, view.height + 1) {}
+
+    static Viewport makeView(const GameConfig& config, int viewWidth, int viewHeight) {
+        Viewport v;
+        v.fit(config.width, config.height, viewWidth, viewHeight);
+        return v;
+    }
+};
+
+// --- Console Utility Functions ---
+
+// Sends the frame drawn into the screen's back buffer to the terminal in a single write
+void presentFrame(FrontEnd& fe) {
+    ProfileScope timing(&fe.profiler, PHASE_PRESENT);
+    string out;
+    fe.screen.present(out);
+    consoleWrite(out);
+}
+
+// Calculates the tick length in milliseconds for the current level
+// All levels will now have the same speed as Level 1 (250 ms unless set with --tick-ms)
+int getSpeedForLevel(const FrontEnd& fe, int) {
+    return fe.baseTickMs;
+}
+
+// Plays a simple beep sound for eating food (queued for the mixer thread; returns at once)
+void playEatSound(FrontEnd& fe) {
+    fe.sound->play(800, 150); // Frequency 800Hz, Duration 150ms
+}
+
+// --- Console Drawing Functions ---
+// The console front-end is a thin client of the simulation core: it draws the board state
+// into the renderer's back buffer and turns key presses into directions for Game::step().
+
+// Gets a wall color based on the level for visual variety
+int getWallColor(int level) {
+    int colors[] = {1, 2, 3, 4, 5, 6, 9, 10, 11, 13}; // Array of console colors
+    return colors[(level - 1) % 10]; // Cycle through colors based on level
+}
+
+// Draws a board cell at its position in the viewport (cells outside the window are skipped)
+void putBoardCell(FrontEnd& fe, const Point& p, char32_t ch, int color) {
+    int x = p.x - fe.view.x, y = p.y - fe.view.y;
+    if (x >= 0 && x < fe.view.width && y >= 0 && y < fe.view.height) fe.screen.put(x, y, ch, color);
+}
+
+// Draws the game borders and level-specific maze patterns in the viewport from the wall runs
+// compiled into the level's layout
+void drawBorders(FrontEnd& fe, const Board& board) {
+    int color = getWallColor(board.level); // Color for walls
+    const vector<int>& runs = board.layout->wallRuns; // (x, y, length) triples, row by row
+    for (size_t i = 0; i + 2 < runs.size(); i += 3) {
+        int y = runs[i + 1] - fe.view.y;
+        if (y < 0) continue;
+        if (y >= fe.view.height) break;
+        int begin = max(runs[i], fe.view.x), end = min(runs[i] + runs[i + 2], fe.view.x + fe.view.width);
+        for (int x = begin; x < end; x++) fe.screen.put(x - fe.view.x, y, WALL_CHAR, color);
+    }
+}
+
+// Draws the food item
+void drawFood(FrontEnd& fe, const Board& board) {
+    if (!board.hasFood) return;
+    putBoardCell(fe, board.food, board.isMoneyFruit ? MONEY_CHAR : FOOD_CHAR,
+                 board.isMoneyFruit ? 14 : 10); // Yellow for money, green for normal
+}
+
+// Draws the snake: green head, red body. A snake longer than the viewport has cells is drawn
+// from the grid cells in the window instead of segment by segment, so the cost of a frame
+// does not grow with the snake.
+void drawSnake(FrontEnd& fe, const Board& board) {
+    const Snake* snake = board.snake;
+    if (snake->length <= fe.view.width * fe.view.height) {
+        for (int i = snake->length - 1; i > 0; i--)
+            putBoardCell(fe, snake->segment(i), SNAKE_BODY_CHAR, 12); // Red for body
+    } else {
+        for (int y = 0; y < fe.view.height; y++)
+            for (int x = 0; x < fe.view.width; x++)
+                if (board.grid.get(fe.view.x + x, fe.view.y + y) == CELL_SNAKE) fe.screen.put(x, y, SNAKE_BODY_CHAR, 12);
+    }
+    putBoardCell(fe, snake->head(), SNAKE_HEAD_CHAR, 10); // Green for head
+}
+
+// Draws the score, level, fruit count, money, high score, and time on the side
+void drawScore(FrontEnd& fe, const Game& game) {
+    const Board& board = *game.board;
+    int x = fe.view.width + 2;
+    fe.screen.text(x, 2, "Level: " + to_string(board.level), 11); // Cyan color
+    fe.screen.text(x, 3, "Score: " + to_string(board.score), 11);
+    fe.screen.text(x, 4, "Fruits: " + to_string(board.fruitCount) + "/" + to_string(board.config.fruitsToClearLevel), 11);
+    fe.screen.text(x, 5, "Money: $" + to_string(game.totalMoneyCollected), 11);
+    fe.screen.text(x, 6, "High Score: " + to_string(fe.highScore), 11);
+    long long seconds = chrono::duration_cast<chrono::seconds>(TickScheduler::Clock::now() - fe.startTime).count();
+    fe.screen.text(x, 7, "Time: " + to_string(seconds) + "s", 11);
+    if (fe.scheduler.overruns > 0) { // Ticks that started late, e.g. because the terminal was slow
+        char lag[64];
+        snprintf(lag, sizeof(lag), "Late ticks: %lld (max %.0f ms)", fe.scheduler.overruns, fe.scheduler.maxOverrunMs());
+        fe.screen.text(x, 9, lag, 8); // Gray
+    }
+}
+
+// Draws a complete frame of the running game into the back buffer
+void drawGame(FrontEnd& fe, const Game& game) {
+    ProfileScope timing(&fe.profiler, PHASE_DRAW);
+    const OccupancyGrid& grid = game.board->grid;
+    if (grid.width != fe.viewBoardWidth || grid.height != fe.viewBoardHeight) { // Pack levels differ in size
+        fe.view.fit(grid.width, grid.height, fe.screen.width - PANEL_WIDTH, fe.screen.height - 1);
+        fe.viewBoardWidth = grid.width;
+        fe.viewBoardHeight = grid.height;
+    }
+    fe.view.follow(game.board->snake->head().x, game.board->snake->head().y, game.board->grid.width,
+                   game.board->grid.height);
+    fe.screen.clear();
+    drawBorders(fe, *game.board);
+    drawFood(fe, *game.board);
+    drawSnake(fe, *game.board);
+    drawScore(fe, game);
+}
+
+// Shows lines at (x, y) for ms milliseconds, then removes them and runs then (if given)
+void showOverlay(FrontEnd& fe, const vector<pair<string, int>>& lines, int x, int y, int ms, bool holdsGame,
+                 bool fullScreen = false, function<void()> then = nullptr) {
+    uint64_t id = fe.nextOverlayId++;
+    fe.overlays.push_back(Overlay{id, lines, x, y, fullScreen, holdsGame});
+    fe.timers.schedule(ms, [&fe, id, then] {
+        for (size_t i = 0; i < fe.overlays.size(); i++)
+            if (fe.overlays[i].id == id) {
+                fe.overlays.erase(fe.overlays.begin() + i);
+                break;
+            }
+        if (then) then();
+    });
+}
+
+// True while an overlay stops the simulation
+bool gameHeld(const FrontEnd& fe) {
+    for (const Overlay& o : fe.overlays)
+        if (o.holdsGame) return true;
+    return false;
+}
+
+// Draws the overlays over whatever is in the back buffer
+void drawOverlays(FrontEnd& fe) {
+    for (const Overlay& o : fe.overlays) {
+        if (o.fullScreen) fe.screen.clear();
+        for (size_t i = 0; i < o.lines.size(); i++)
+            fe.screen.text(o.x, o.y + (int)i, o.lines[i].first, o.lines[i].second);
+    }
+}
+
+// Runs the overlay timers that are due
+void advanceTimers(FrontEnd& fe) {
+    fe.timers.advance(chrono::duration_cast<chrono::milliseconds>(TickScheduler::Clock::now() - fe.clockOrigin).count());
+}
+
+// Handles user input for snake direction and pause/resume
+// Drains every command the input thread has queued since the last tick: turns go into the
+// turn buffer (one is applied per tick), pause toggles at once. A left/right press marks the
+// time of the last speed boost request, so the boost does not depend on when the loop polls.
+// With acceptTurns false (autopilot playing) only pause and quit are taken from the queue.
+void getInput(FrontEnd& fe, CommandQueue& commands, TurnBuffer& turns, const Snake& snake,
+              TickScheduler::Clock::time_point& lastBoostRequest, bool acceptTurns = true) {
+    InputCommand cmd;
+    while (commands.tryPop(cmd)) {
+        if (cmd.type == CMD_PAUSE) {
+            fe.isPaused = !fe.isPaused; // Toggle pause state (the next frame drops the pause message)
+        } else if (cmd.type == CMD_QUIT) {
+            fe.quitRequested = true;
+        } else if (cmd.type == CMD_TURN && acceptTurns) {
+            turns.push(cmd.direction, snake.direction);
+            if (cmd.direction == DIR_LEFT || cmd.direction == DIR_RIGHT) {
+                lastBoostRequest = cmd.timestamp; // Holding LEFT/RIGHT requests a speed boost
+            }
+        }
+    }
+}
+
+// --- Game Management Functions ---
+
+// Displays game instructions and prompts for starting level (1 to levelCount); returns it
+int showInstructions(int levelCount) {
+    consoleWrite("\x1b[0m\x1b[2J\x1b[H"); // Clear console screen
+    string cyan = "\x1b[" + to_string(ansiColorCode(11)) + "m";
+    string yellow = "\x1b[" + to_string(ansiColorCode(14)) + "m";
+    cout << cyan;
+    cout << "=============== Snake Game ===============\n";
+    cout << "Use W A S D or Arrow Keys to move the snake.\n";
+    cout << "Hold LEFT/RIGHT arrow or 'A'/'D' for 2x speed!\n"; // Added instruction
+    cout << "* = Normal fruit, $ = Money fruit (+$100)\n";
+    cout << "Eat 15 fruits to complete a level.\n"; // Updated instruction
+    cout << "Walls appear from level 2 onwards.\n";
+    cout << "Press 'P' to pause/resume, 'Q' to quit.\n";
+    cout << "==========================================\n";
+    cout << yellow;
+    cout << "Enter Starting Level (1-" << levelCount << "): " << flush;
+    int level;
+    cin >> level; // Get user input for starting level
+    // Validate input, default to 1 if invalid
+    if (level < 1 || level > levelCount) level = 1;
+    cout << "\x1b[0m"; // Reset color
+    cout << "Press any key to start...\n" << flush;
+    consoleInit(); // Switch to unbuffered keys and a hidden cursor for the game itself
+    consoleReadKey(); // Wait for any key press
+    return level;
+}
+
+// Adds a finished session to the score log and updates the high score. The record is written
+// at once: Ctrl+C ends the program without running destructors, so nothing buffered survives it.
+void recordRun(FrontEnd& fe, const Game& game, int startLevel, long long ticks) {
+    long long ms = chrono::duration_cast<chrono::milliseconds>(TickScheduler::Clock::now() - fe.startTime).count();
+    fe.scores.add(RunRecord::of(game, startLevel, ticks, (uint32_t)ms));
+    fe.scores.flush();
+    if (game.won) fe.highScore = max(fe.highScore, game.totalMoneyCollected); // Only a won game sets the high score
+}
+
+// Prints how well the game loop kept its schedule (late ticks, and keys dropped because it fell
+// behind reading them), how long each phase of a tick took and how long the autopilot took
+// to plan, and writes the trace if one was requested
+void reportTiming(const FrontEnd& fe, const InputThread& input, const Autopilot* autopilot) {
+    fprintf(stderr, "Ticks: %lld, late: %lld (avg %.2f ms, max %.2f ms), keys dropped: %lld\n", fe.scheduler.ticks,
+            fe.scheduler.overruns, fe.scheduler.averageOverrunMs(), fe.scheduler.maxOverrunMs(), input.dropped.load());
+    fe.profiler.report(stderr);
+    if (autopilot) {
+        fprintf(stderr, "Autopilot (%s): %lld plans, avg %.1f us, max %.1f us\n", autopilot->strategy->name(),
+                autopilot->plans, autopilot->averagePlanUs(), autopilot->maxPlanUs());
+    }
+    if (!fe.tracePath.empty() && !fe.profiler.writeTrace(fe.tracePath))
+        fprintf(stderr, "Cannot write %s\n", fe.tracePath.c_str());
+}
+
+// Saves the session being played when the player quits, with the seeds of the sessions after
+// it, so the next start resumes it exactly
+void saveSession(const FrontEnd& fe, const Game& game, int startLevel, long long ticks, uint64_t nextSeed,
+                 const Rng& sessionSeeds) {
+    long long ms = chrono::duration_cast<chrono::milliseconds>(TickScheduler::Clock::now() - fe.startTime).count();
+    Snapshot snapshot = Snapshot::capture(game, startLevel, ticks, ms);
+    snapshot.driver = {nextSeed, sessionSeeds.state};
+    string error;
+    if (!snapshot.save(fe.savePath, error)) fprintf(stderr, "Cannot save the game: %s\n", error.c_str());
+}
+
+// --- Main Game Loop ---
+int main(int argc, char** argv) {
+    GameConfig config;      // Board size (--width, --height)
+    int viewWidth = VIEW_WIDTH, viewHeight = VIEW_HEIGHT; // Largest board window on screen (--view)
+    int tickMs = 250;       // Tick length (--tick-ms)
+    uint64_t seed = 0;      // Seed of the first session (--seed), otherwise taken from the clock
+    bool seedGiven = false;
+    string recordPath;      // Each finished session's replay is written here (--record)
+    string tracePath;       // Chrome trace of the loop's phases (--trace)
+    bool skipBanners = false; // Banners last one tick (--skip-banners), e.g. for autopilot soak runs
+    string soundPath;       // Sounds go to this WAV file instead of the speaker (--sound-file)
+    bool mute = false;      // No sound at all (--mute)
+    string levelsPath;      // Level pack played instead of the built-in levels (--levels)
+    string scoresPath = "scores.log"; // Log of finished runs (--scores)
+    string savePath = "snake.sav"; // Session saved on quit and resumed on the next start (--save)
+    unique_ptr<Autopilot> autopilot; // Plays instead of the keyboard (--autopilot)
+    // Parse command line options
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--tick-ms" && i + 1 < argc) tickMs = max(1, atoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc) { seed = strtoull(argv[++i], nullptr, 10); seedGiven = true; }
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (arg == "--skip-banners") skipBanners = true;
+        else if (arg == "--sound-file" && i + 1 < argc) soundPath = argv[++i];
+        else if (arg == "--mute") mute = true;
+        else if (arg == "--levels" && i + 1 < argc) levelsPath = argv[++i];
+        else if (arg == "--scores" && i + 1 < argc) scoresPath = argv[++i];
+        else if (arg == "--save" && i + 1 < argc) savePath = argv[++i];
+        else if (arg == "--autopilot" && i + 1 < argc && makeAutopilotStrategy(argv[i + 1]))
+            autopilot.reset(new Autopilot(makeAutopilotStrategy(argv[++i])));
+        else if (arg == "--width" && i + 1 < argc) config.setSize(atoi(argv[++i]), config.height);
+        else if (arg == "--height" && i + 1 < argc) config.setSize(config.width, atoi(argv[++i]));
+        else if (arg == "--view" && i + 2 < argc) {
+            viewWidth = max(MIN_BOARD_WIDTH, atoi(argv[++i]));
+            viewHeight = max(MIN_BOARD_HEIGHT, atoi(argv[++i]));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--tick-ms N] [--seed S] [--record FILE] [--autopilot bfs|astar|cycle]"
+                 << " [--width W] [--height H] [--view W H] [--trace FILE] [--skip-banners]"
+                 << " [--sound-file FILE.wav | --mute] [--levels FILE] [--scores FILE] [--save FILE]\n";
+            return 1;
+        }
+    }
+    unique_ptr<LevelSource> levels; // Shared by every session, so each level is compiled once
+    if (!levelsPath.empty()) {
+        unique_ptr<LevelPack> pack(new LevelPack());
+        string error;
+        if (!pack->open(levelsPath, error)) {
+            cerr << "Cannot load levels: " << error << "\n";
+            return 1;
+        }
+        if (!recordPath.empty()) {
+            cerr << "Replays are of the built-in levels only\n";
+            return 1;
+        }
+        config.setSize(viewWidth, viewHeight); // Pack boards have their own sizes: make the screen as large as the view
+        levels = std::move(pack);
+    } else {
+        levels.reset(new BuiltinLevels(config.width, config.height));
+    }
+    for (int l = 1; autopilot && l <= levels->levelCount(); l++) {
+        GameConfig size = config;
+        int width, height;
+        if (levels->boardSize(l, width, height)) size.setSize(width, height);
+        if (autopilotSupports(size)) continue;
+        cerr << "The autopilot cannot play a " << size.width << "x" << size.height << " board\n";
+        return 1;
+    }
+    FrontEnd fe(config, viewWidth, viewHeight); // Session state: settings, pause, high score, clock and screen
+    fe.levels = std::move(levels);
+    fe.baseTickMs = tickMs;
+    fe.tracePath = tracePath;
+    fe.savePath = savePath;
+    fe.timers.skipDelays = skipBanners;
+    if (mute) {
+        fe.sound.reset(new SoundEngine(unique_ptr<SoundSink>(new NullSoundSink())));
+    } else if (!soundPath.empty()) {
+        unique_ptr<WavSoundSink> wav(new WavSoundSink(soundPath, SOUND_SAMPLE_RATE));
+        if (!wav->isOpen()) {
+            cerr << "Cannot write " << soundPath << "\n";
+            return 1;
+        }
+        fe.sound.reset(new SoundEngine(std::move(wav), SOUND_SAMPLE_RATE));
+    } else {
+        fe.sound.reset(new SoundEngine(unique_ptr<SoundSink>(new ConsoleBeepSink())));
+    }
+    if (!tracePath.empty()) fe.profiler.enableTrace(TRACE_CAPACITY);
+    string scoresError;
+    if (!fe.scores.open(scoresPath, scoresError)) // Play on; the runs are just not kept
+        cerr << "Scores will not be saved: " << scoresError << "\n";
+    fe.highScore = fe.scores.bestWonMoney();
+
+    if (!seedGiven) seed = (uint64_t)time(0); // Seed random number generator with current time
+    Rng sessionSeeds(seed); // Seeds for the sessions after a game over
+
+    // A session quit with 'Q' last time carries on where it stopped, paused, without the instructions
+    Game* resumed = nullptr;
+    Snapshot snapshot;
+    if (ifstream(savePath).good()) {
+        string error;
+        if (snapshot.load(savePath, error) && snapshot.driver.size() == 2 &&
+            (resumed = snapshot.restore(fe.levels.get(), error))) {
+            remove(savePath.c_str()); // Resumed once; quitting again saves it anew
+            seed = snapshot.driver[0];
+            sessionSeeds.state = snapshot.driver[1];
+        } else {
+            cerr << "Cannot resume the saved game: " << (error.empty() ? "not saved by this game" : error) << "\n";
+        }
+    }
+
+    int currentLevel;
+    if (resumed) {
+        currentLevel = snapshot.startLevel;
+        consoleInit(); // Unbuffered keys and a hidden cursor, as after the instructions
+        fe.isPaused = true;
+        fe.startTime = TickScheduler::Clock::now() - chrono::milliseconds(snapshot.elapsedMs); // Clock goes on from the save
+    } else {
+        fe.scores.setStartLevel(showInstructions(fe.levels->levelCount())); // Display instructions and get starting level
+        fe.scores.flush(); // Kept even if the session is ended with Ctrl+C
+        currentLevel = fe.scores.startLevel(); // The starting level is kept in the score log across runs
+        fe.startTime = TickScheduler::Clock::now(); // Record the start time of the game
+    }
+
+    CommandQueue commands;                // Key presses from the input thread, oldest first
+    InputThread inputThread(commands);    // Reads the keyboard until main() returns
+    TickScheduler::Clock::time_point lastBoostRequest; // Time of the last LEFT/RIGHT key press
+
+    // Main game loop: each iteration plays one session until game over
+    while (true) {
+        // Create a new session starting at the level, unless the saved one goes on
+        if (!resumed && !fe.levels->layout(currentLevel)) {
+            consoleRestore();
+            cerr << "Cannot play: " << fe.levels->layoutError(currentLevel) << "\n";
+            return 1;
+        }
+        Game* game = resumed ? resumed : new Game(currentLevel, seed, fe.config, fe.levels.get());
+        int base_speed = getSpeedForLevel(fe, game->currentLevel); // Get base tick length (250 ms by default)
+        game->attachProfiler(&fe.profiler);         // Time the move and spawn phases of each step
+        ReplayRecorder recorder(seed, currentLevel, fe.config); // Turns applied this session, for --record
+        bool recording = !recordPath.empty() && !resumed; // A resumed session has no replay from its start
+        int sessionStartLevel = currentLevel;       // Kept with the run in the score log
+        long long sessionTicks = resumed ? snapshot.ticks : 0; // Ticks played this session
+        if (!resumed) seed = sessionSeeds.next64(); // The next session after a game over gets a fresh seed
+        resumed = nullptr;
+        TurnBuffer turns;                           // Turns waiting for the next ticks
+        InputCommand stale;
+        while (commands.tryPop(stale)) {}           // Drop keys pressed during the previous banners
+
+        fe.screen.invalidate(); // Repaint the whole screen for the new level
+        drawGame(fe, *game);
+        presentFrame(fe);
+        fe.scheduler.reset(); // First tick is one period from now
+
+        bool sessionOver = false; // Set when the game over banner has been shown
+        bool allCleared = false;  // Set when the congratulations banner has been shown
+
+        // Inner game loop: runs until game over or all levels cleared
+        while (true) {
+            Profiler::Clock::time_point tickStart = fe.profiler.now();
+            bool held = gameHeld(fe);
+            {
+                ProfileScope timing(&fe.profiler, PHASE_INPUT);
+                getInput(fe, commands, turns, *game->board->snake, lastBoostRequest, !autopilot && !held); // Process queued user input
+            }
+            if (fe.quitRequested) { // 'Q': leave through the same reporting as a finished game
+                if (!game->over) saveSession(fe, *game, sessionStartLevel, sessionTicks, seed, sessionSeeds);
+                delete game;
+                reportTiming(fe, inputThread, autopilot.get());
+                return 0;
+            }
+            advanceTimers(fe); // Take down overlays whose time is up, start the next banner
+            if (sessionOver) break; // Exit inner loop to start new game
+            if (allCleared) {
+                delete game;
+                reportTiming(fe, inputThread, autopilot.get());
+                return 0; // Exit program if all levels are done
+            }
+            held = gameHeld(fe);
+
+            if (held) {
+                // A banner holds the game: the last frame stays up under it, the simulation waits
+                ProfileScope timing(&fe.profiler, PHASE_BANNER);
+                drawOverlays(fe);
+                presentFrame(fe);
+                fe.scheduler.waitForNextTick(chrono::milliseconds(base_speed));
+                continue;
+            }
+            if (autopilot && !fe.isPaused) {
+                // The autopilot's turn goes through its own queue and the turn buffer like a key press
+                TickScheduler::Clock::time_point noBoost;
+                {
+                    ProfileScope timing(&fe.profiler, PHASE_AUTOPILOT);
+                    autopilot->issue(*game->board);
+                }
+                ProfileScope timing(&fe.profiler, PHASE_INPUT);
+                getInput(fe, autopilot->commands, turns, *game->board->snake, noBoost);
+            }
+
+            if (!fe.isPaused) {
+                // Boost while LEFT/RIGHT presses keep arriving (key repeat) within one tick
+                bool speedBoostRequested = TickScheduler::Clock::now() - lastBoostRequest < chrono::milliseconds(base_speed);
+                int effective_speed = base_speed;
+                if (speedBoostRequested) {
+                    effective_speed = base_speed / 2; // Double speed (half sleep time)
+                    if (effective_speed < 50) effective_speed = min(50, base_speed); // Ensure a minimum speed (e.g., 50ms)
+                }
+
+                int clearedLevel = game->currentLevel;
+                char turn = turns.pop();        // Apply one queued turn per tick
+                if (recording) recorder.record(turn);
+                int events = game->step(turn);  // Advance the simulation by one tick
+                sessionTicks++;
+                if (!game->error.empty()) { // The next level cannot be built: nothing to play on with
+                    consoleRestore();
+                    cerr << "\nCannot play on: " << game->error << "\n";
+                    delete game;
+                    return 1;
+                }
+                if (game->over) recordRun(fe, *game, sessionStartLevel, sessionTicks); // Died or won: keep the run
+
+                if (game->over && recording) { // Keep the replay of every finished session
+                    recorder.finish(*game);
+                    recorder.save(recordPath);
+                }
+
+                if (events & EVENT_DIED) { // Game Over: show it for 3 seconds, then restart
+                    showOverlay(fe, {{"💀 GAME OVER!", 12}, // Red color
+                                     {"Total Money Earned: $" + to_string(game->totalMoneyCollected), 12},
+                                     {"Restarting from Level 1...", 12}}, 10, 10, 3000, true, true,
+                                [&] { sessionOver = true; });
+                    currentLevel = 1; // Reset to level 1 (the new session starts with no money)
+                }
+
+                // On a level clear the session has already moved on to the next board,
+                // so the last frame of the cleared level stays up under the banners
+                if (!(events & (EVENT_LEVEL_CLEARED | EVENT_DIED))) drawGame(fe, *game);
+
+                if (events & EVENT_MONEY) { // Shown for a second while the game goes on
+                    showOverlay(fe, {{"  Bonus Collected! +$100  ", 14}}, 10, fe.view.height, 1000, false); // Yellow color
+                }
+                if (events & EVENT_ATE_FOOD) {
+                    ProfileScope timing(&fe.profiler, PHASE_SOUND);
+                    playEatSound(fe); // Play sound
+                }
+
+                if (events & EVENT_LEVEL_CLEARED) { // Level Cleared: two banners of 1.5 seconds each
+                    bool won = (events & EVENT_GAME_WON) != 0;
+                    auto congratulate = [&] { // All levels completed: 4 seconds, then exit
+                        showOverlay(fe, {{"🏆 CONGRATULATIONS! All levels complete.", 11},
+                                         {"💰 Total Money Earned: $" + to_string(game->totalMoneyCollected), 11}},
+                                    fe.view.width / 2 - 15, fe.view.height / 2 - 2, 4000, true, true,
+                                    [&] { allCleared = true; });
+                    };
+                    auto announce = [&, clearedLevel, won, congratulate] {
+                        showOverlay(fe, {{"✅ LEVEL " + to_string(clearedLevel) + " CLEARED!     ", 10}}, // Green color
+                                    10, 10, 1500, true, false, won ? function<void()>(congratulate) : nullptr);
+                    };
+                    showOverlay(fe, {{" 🎉 Level Cleared!    ", 14}}, 10, fe.view.height, 1500, true, false, announce);
+                    base_speed = getSpeedForLevel(fe, game->currentLevel);
+                    turns.clear(); // Turns meant for the old board don't carry over
+                }
+                drawOverlays(fe);
+                presentFrame(fe); // Send the frame to the terminal in one write
+                // Sleep until this tick's deadline; time spent updating and drawing is already part of it
+                {
+                    ProfileScope timing(&fe.profiler, PHASE_SLEEP);
+                    fe.scheduler.waitForNextTick(chrono::milliseconds(effective_speed));
+                }
+                fe.profiler.record(PHASE_TICK, tickStart);
+            } else {
+                // Game is paused
+                drawGame(fe, *game);
+                drawOverlays(fe);
+                fe.screen.text(10, 10, "= PAUSED == Press 'P' to resume =", 14);
+                presentFrame(fe);
+                sleepMs(100); // Short sleep to prevent busy-waiting
+                fe.scheduler.reset(); // Resume on a fresh schedule instead of catching up
+            }
+        }
+        fe.timers.clear(); // Nothing of the finished session stays on screen
+        fe.overlays.clear();
+        fe.startTime = TickScheduler::Clock::now(); // Reset game timer
+        delete game; // Clean up the session before starting a new game
+    }
+
+    return 0; // Program exits
+}
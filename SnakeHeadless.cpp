@@ -0,0 +1,573 @@
+// SnakeHeadless.cpp
+// Headless driver for the simulation core: no console, no sound, no sleeping unless a tick rate is requested.
+// Steps games as fast as the CPU allows with a random-turn player and reports
+// the tick rate. Used for testing the core on any platform and for load generation.
+// It also records and plays back replays, for reproducing bug reports and for checking
+// that changes to the core leave the outcome of a recorded session unchanged.
+// With --autopilot the built-in AI plays instead of the random player, to check that
+// levels can be cleared and to measure planning cost. --batch runs many independent games
+// (and any --replay files) on a work-stealing thread pool and prints aggregate statistics.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o SnakeHeadless SnakeHeadless.cpp
+// Usage: SnakeHeadless [--ticks N] [--level L] [--seed S] [--tick-ms N]
+//                      [--record FILE | --replay FILE] [--autopilot bfs|astar|cycle]
+//                      [--batch N] [--threads T] [--width W] [--height H]
+//                      [--levels FILE | --mazes N [--difficulty D]] [--save-levels FILE]
+//                      [--scores FILE] [--checkpoint FILE [--checkpoint-every N]] [--resume FILE]
+//                      [--arena N [--arena-food F] [--replay FILE]...]
+//   --tick-ms paces the run at a fixed tick rate (default 0 = uncapped)
+//   --record  plays a single session and saves its replay
+//   --replay  plays a replay back at full speed and checks the final state
+//   --batch   plays N games with different seeds, starting on levels 1-6 in turn unless --level
+//             is given; --ticks then caps each game. --replay may be repeated to verify
+//             several replays in the same batch. --threads defaults to every core.
+//   --width, --height set the board size (up to 4096 x 4096; large boards use chunked storage
+//             and cannot be played by the autopilot)
+//   --levels  plays the levels of a level pack (LevelPack.h) instead of the built-in ones, at
+//             the pack's board sizes; replays are of built-in levels only
+//   --mazes   plays N procedurally generated maze levels (MazeGenerator.h) at the board size,
+//             generated on --threads cores; --difficulty from 0 (open) to 1 (narrow), default 0.5
+//   --save-levels writes the --levels pack or the generated mazes as a binary pack and exits
+//   --scores  appends every finished game (every game of a batch) to a score log (ScoreStore.h)
+//             and prints its leaderboard
+//   --checkpoint saves the run (the game being played and the run's counters) as a snapshot
+//             (Snapshot.h) every N ticks (default 1000000) and when the tick budget runs out;
+//             --resume carries on from one until the run has played --ticks in total, ending
+//             exactly as the run would have without the break (random player)
+//   --arena   runs N snakes at once on the --level layout (Arena.h) with F food items (default
+//             N / 4), the parallel phases of each tick on --threads cores, for --ticks ticks
+//             (default 1000); dead snakes respawn. The arena AI drives the snakes, except that
+//             each --replay file's turn log drives one snake (the first file snake 0, and so on)
+//             until the log runs out. Prints the move rate, the deaths by cause and a hash of
+//             the final state, which is the same for any number of threads
+
+#include <bits/stdc++.h> // Includes most standard libraries
+#include "SnakeCore.h"   // Platform-neutral game simulation (Point, Snake, Board, Game)
+#include "TickScheduler.h" // Fixed-timestep game clock
+#include "Replay.h"      // Replay recording and playback
+#include "Autopilot.h"   // Built-in AI player
+#include "WorkStealingPool.h" // Thread pool for batch mode
+#include "LevelPack.h"   // Levels loaded from a file (--levels)
+#include "MazeGenerator.h" // Generated maze levels (--mazes)
+#include "ScoreStore.h"  // Log of finished runs (--scores)
+#include "Snapshot.h"    // Checkpoints of long runs (--checkpoint, --resume)
+#include "Arena.h"       // Many snakes on one board (--arena)
+
+using namespace std;
+
+// Picks the input for the next tick: keep going straight most of the time,
+// occasionally request a random turn (the core ignores 180-degree turns)
+char randomTurn(Rng& rng) {
+    static const char dirs[] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+    if (rng.below(8) != 0) return DIR_NONE;
+    return dirs[rng.below(4)];
+}
+
+// Lets the autopilot plan this tick and passes its command through a turn buffer, the same
+// path key presses take in the console game
+char autopilotTurn(Autopilot& autopilot, TurnBuffer& turns, const Board& board) {
+    autopilot.issue(board);
+    InputCommand cmd;
+    while (autopilot.commands.tryPop(cmd)) {
+        if (cmd.type == CMD_TURN) turns.push(cmd.direction, board.snake->direction);
+    }
+    return turns.pop();
+}
+
+// Plays a replay file back at full speed and reports whether it ends in the recorded state
+int playReplay(const string& path) {
+    ReplayPlayer player;
+    if (!player.load(path)) {
+        cerr << "Cannot read replay " << path << "\n";
+        return 1;
+    }
+    Game game(player.startLevel, player.seed, player.config);
+    long long fruits = 0;
+    auto begin = chrono::steady_clock::now();
+    while (!player.finished() && !game.over) {
+        if (game.step(player.next()) & EVENT_ATE_FOOD) fruits++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    uint64_t hash = hashGame(game);
+    bool match = hash == player.finalHash && player.finished();
+    cout << "ticks:          " << player.tick << " / " << player.totalTicks << "\n";
+    cout << "level reached:  " << game.currentLevel << (game.won ? " (won)" : "") << "\n";
+    cout << "fruits:         " << fruits << "\n";
+    cout << "money:          " << game.totalMoneyCollected << "\n";
+    cout << "seconds:        " << fixed << setprecision(3) << seconds << "\n";
+    cout << "final state:    " << hex << hash << dec << (match ? " (matches recording)" : " (DIFFERS from recording)") << "\n";
+    return match ? 0 : 2;
+}
+
+// --- Batch Mode ---
+
+// One game of a batch: a seed and start level played by the autopilot or the random player,
+// or a replay file to verify
+struct BatchJob {
+    uint64_t seed;
+    int startLevel;
+    string replayPath; // Empty for generated games
+};
+
+// What one game of a batch produced
+struct BatchResult {
+    long long ticks = 0;               // Ticks survived (until death, the win, or the tick cap)
+    vector<int> fruits;                // Fruits eaten on each level (index = level number)
+    vector<int> attempted;             // 1 for each level the game played
+    vector<int> cleared;               // 1 for each level it cleared
+    bool died = false, won = false;
+    bool loaded = true;                // Replay jobs: the file could be read
+    bool replayMatch = true;           // Replay jobs: playback ended in the recorded state
+    int worker = 0;                    // Worker that ran the game
+    double seconds = 0;                // Time the game took
+    RunRecord run;                     // Generated games: the run as it goes into the score log
+    string error;                      // A level the game needed could not be built
+};
+
+// Plays one batch game to the end. Everything it touches is local, so any number of these
+// run in parallel.
+BatchResult runBatchJob(const BatchJob& job, const GameConfig& config, LevelSource* levels, const string& strategy,
+                        long long maxTicks) {
+    BatchResult r;
+    bool replay = !job.replayPath.empty();
+    int levelCount = replay || !levels ? MAX_LEVEL : levels->levelCount();
+    r.fruits.assign(levelCount + 1, 0);
+    r.attempted.assign(levelCount + 1, 0);
+    r.cleared.assign(levelCount + 1, 0);
+    ReplayPlayer player;
+    if (replay && !player.load(job.replayPath)) {
+        r.loaded = r.replayMatch = false;
+        return r;
+    }
+    if (!replay && levels && !levels->layout(job.startLevel)) {
+        r.error = levels->layoutError(job.startLevel);
+        return r;
+    }
+    Game game(replay ? player.startLevel : job.startLevel, replay ? player.seed : job.seed, replay ? player.config : config,
+              replay ? nullptr : levels);
+    unique_ptr<Autopilot> autopilot;
+    if (!replay && !strategy.empty()) autopilot.reset(new Autopilot(makeAutopilotStrategy(strategy)));
+    Rng input(job.seed ^ 0x9E3779B97F4A7C15ULL); // The random player's own stream
+    TurnBuffer turns;
+
+    auto begin = chrono::steady_clock::now();
+    r.attempted[game.currentLevel] = 1;
+    while (!game.over && (replay ? !player.finished() : r.ticks < maxTicks)) {
+        char turn = replay ? player.next() : autopilot ? autopilotTurn(*autopilot, turns, *game.board) : randomTurn(input);
+        int level = game.currentLevel;
+        int events = game.step(turn);
+        r.ticks++;
+        if (events & EVENT_ATE_FOOD) r.fruits[level]++;
+        if (events & EVENT_LEVEL_CLEARED) {
+            r.cleared[level] = 1;
+            turns.clear();
+            if (!game.over) r.attempted[game.currentLevel] = 1;
+        }
+    }
+    r.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    r.error = game.error;
+    r.died = game.over && !game.won && r.error.empty();
+    r.won = game.won;
+    if (replay) r.replayMatch = player.finished() && hashGame(game) == player.finalHash;
+    else r.run = RunRecord::of(game, job.startLevel, r.ticks, (uint32_t)(r.seconds * 1000));
+    return r;
+}
+
+// Prints the best runs of the score log and the best run ending on each level
+void printLeaderboard(const ScoreStore& scores, const string& path) {
+    cout << "score log:      " << path << " (" << scores.runCount() << " runs indexed, " << scores.recordCount()
+         << " records, " << scores.compactions << " compactions)\n";
+    cout << "rank  money  score  start  reached        ticks                  seed\n";
+    vector<RunRecord> best = scores.top(5);
+    for (size_t i = 0; i < best.size(); i++) {
+        const RunRecord& r = best[i];
+        cout << setw(4) << i + 1 << setw(7) << r.money << setw(7) << r.score << setw(7) << r.startLevel << setw(9)
+             << r.levelReached << (r.won ? "w" : " ") << setw(12) << r.ticks << setw(22) << r.seed << "\n";
+    }
+    cout << "level best:    ";
+    for (int l : scores.levels()) {
+        RunRecord r;
+        if (scores.bestOfLevel(l, r)) cout << " " << l << ": $" << r.money << "/" << r.score;
+    }
+    cout << "\n";
+}
+
+// Runs every job on a work-stealing pool and prints aggregate statistics.
+// Returns 0, or 2 if a replay could not be read or did not reproduce its recording or a game
+// met a level that could not be built.
+// Generated games are added to scores if it is open.
+int runBatch(const vector<BatchJob>& jobs, const GameConfig& config, LevelSource* levels, const string& strategy,
+             long long maxTicks, int threads, ScoreStore& scores) {
+    vector<BatchResult> results(jobs.size());
+    auto begin = chrono::steady_clock::now();
+    int workers;
+    vector<WorkStealingPool::WorkerStats> workerStats;
+    {
+        WorkStealingPool pool(threads);
+        workers = pool.size();
+        for (size_t i = 0; i < jobs.size(); i++) {
+            pool.submit([&, i](int worker) {
+                results[i] = runBatchJob(jobs[i], config, levels, strategy, maxTicks);
+                results[i].worker = worker;
+            });
+        }
+        pool.wait();
+        for (int w = 0; w < workers; w++) workerStats.push_back(pool.stats(w));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    // Aggregate
+    long long totalTicks = 0, deaths = 0, wins = 0, replays = 0, badReplays = 0, levelErrors = 0;
+    int levelCount = levels ? max(levels->levelCount(), MAX_LEVEL) : MAX_LEVEL; // Replays play built-in levels
+    vector<long long> fruits(levelCount + 1, 0), attempted(levelCount + 1, 0), cleared(levelCount + 1, 0);
+    vector<long long> survival, workerTicks(workers, 0);
+    vector<double> workerSeconds(workers, 0.0);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BatchResult& r = results[i];
+        if (!jobs[i].replayPath.empty()) {
+            replays++;
+            if (!r.replayMatch) {
+                badReplays++;
+                cerr << (r.loaded ? "Replay differs from recording: " : "Cannot read replay ") << jobs[i].replayPath << "\n";
+            }
+        }
+        if (!r.loaded) continue;
+        if (!r.error.empty()) { // Reported once: every game reaching the level fails the same way
+            if (levelErrors++ == 0) cerr << "Cannot play: " << r.error << "\n";
+            continue;
+        }
+        if (jobs[i].replayPath.empty() && scores.isOpen()) scores.add(r.run);
+        totalTicks += r.ticks;
+        survival.push_back(r.ticks);
+        deaths += r.died;
+        wins += r.won;
+        for (int l = 1; l < (int)r.attempted.size(); l++) {
+            fruits[l] += r.fruits[l];
+            attempted[l] += r.attempted[l];
+            cleared[l] += r.cleared[l];
+        }
+        workerTicks[r.worker] += r.ticks;
+        workerSeconds[r.worker] += r.seconds;
+    }
+    sort(survival.begin(), survival.end());
+
+    cout << "games:          " << results.size() << " (" << replays << " replays) on " << workers << " threads\n";
+    cout << "player:         " << (strategy.empty() ? "random" : strategy) << "\n";
+    cout << "died / won:     " << deaths << " / " << wins << "\n";
+    if (!survival.empty()) {
+        cout << "survival ticks: mean " << totalTicks / (long long)survival.size() << ", median "
+             << survival[survival.size() / 2] << ", min " << survival.front() << ", max " << survival.back() << "\n";
+    }
+    cout << "level  played  cleared  clear rate  fruits/game\n";
+    for (int l = 1; l <= levelCount; l++) {
+        if (attempted[l] == 0) continue;
+        cout << setw(5) << l << setw(8) << attempted[l] << setw(9) << cleared[l] << setw(11) << fixed << setprecision(1)
+             << 100.0 * cleared[l] / attempted[l] << "%" << setw(13) << setprecision(2) << (double)fruits[l] / attempted[l] << "\n";
+    }
+    cout << "worker  games  stolen        ticks  ticks/sec\n";
+    for (int w = 0; w < workers; w++) {
+        cout << setw(6) << w << setw(7) << workerStats[w].executed << setw(8) << workerStats[w].stolen << setw(13)
+             << workerTicks[w] << setw(11) << setprecision(0) << (workerSeconds[w] > 0 ? workerTicks[w] / workerSeconds[w] : 0.0) << "\n";
+    }
+    cout << "seconds:        " << setprecision(3) << seconds << "\n";
+    cout << "ticks/sec:      " << setprecision(0) << (seconds > 0 ? totalTicks / seconds : 0.0) << " total, "
+         << (seconds > 0 ? totalTicks / seconds / workers : 0.0) << " per thread\n";
+    if (levelErrors) cerr << levelErrors << " games stopped at a level that could not be built\n";
+    return badReplays || levelErrors ? 2 : 0;
+}
+
+// Runs an arena of snakeCount snakes on the layout for the given ticks and prints its statistics.
+// Snake k follows the turn log of replayPaths[k] (only the turns: the replay's seed, level and
+// board are not used) until it runs out; the arena AI drives every other snake.
+int runArena(shared_ptr<const LevelLayout> layout, int snakeCount, int foodCount, uint64_t seed, long long ticks, int threads,
+             const vector<string>& replayPaths) {
+    if ((int)replayPaths.size() > snakeCount) {
+        cerr << "More replays than arena snakes\n";
+        return 1;
+    }
+    vector<ReplayPlayer> players(replayPaths.size());
+    for (size_t k = 0; k < replayPaths.size(); k++) {
+        if (!players[k].load(replayPaths[k])) {
+            cerr << "Cannot read replay " << replayPaths[k] << "\n";
+            return 1;
+        }
+    }
+    Arena arena(layout, snakeCount, foodCount, seed);
+    WorkStealingPool pool(threads);
+    vector<char> turns(snakeCount);
+    cout << "arena:          " << snakeCount << " snakes (" << arena.aliveCount() << " placed, " << players.size()
+         << " replayed), " << arena.food.size() << " food on " << layout->width << "x" << layout->height << " ("
+         << layout->name << ") on " << pool.size() << " threads\n";
+    auto begin = chrono::steady_clock::now();
+    double planning = 0; // Seconds in the arena AI
+    for (long long t = 0; t < ticks; t++) {
+        auto planned = chrono::steady_clock::now();
+        arena.chooseTurns(turns.data(), &pool);
+        planning += chrono::duration<double>(chrono::steady_clock::now() - planned).count();
+        for (size_t k = 0; k < players.size(); k++) // Replayed snakes: the logged turn replaces the AI's
+            if (!players[k].finished()) turns[k] = players[k].next();
+        arena.step(turns.data(), &pool);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    const Arena::Stats& s = arena.stats;
+    cout << "ticks:          " << arena.ticks << "\n";
+    cout << "alive:          " << arena.aliveCount() << ", longest " << arena.longest() << "\n";
+    cout << "food eaten:     " << s.eaten << "\n";
+    cout << "deaths:         " << s.wallDeaths + s.bodyDeaths + s.headOnDeaths << " (wall " << s.wallDeaths << ", body "
+         << s.bodyDeaths << ", head-on " << s.headOnDeaths << "), " << s.respawns << " respawns\n";
+    cout << "seconds:        " << fixed << setprecision(3) << seconds << " (AI " << planning << ", parallel phases "
+         << s.parallelNs / 1e9 << ", ordered phases " << s.serialNs / 1e9 << ")\n";
+    cout << "ticks/sec:      " << setprecision(0) << (seconds > 0 ? arena.ticks / seconds : 0.0) << "\n";
+    cout << "moves/sec:      " << (seconds > 0 ? s.moves / seconds : 0.0) << "\n";
+    cout << "state hash:     " << hex << setw(16) << setfill('0') << arena.hash() << dec << setfill(' ') << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long maxTicks = 10000000; // Number of ticks to simulate
+    bool ticksGiven = false;
+    int startLevel = 1;            // Level every session starts at
+    uint64_t seed = (uint64_t)time(0);
+    double tickMs = 0;             // Tick length; 0 runs uncapped
+    string recordPath;             // Replay to write
+    vector<string> replayPaths;    // Replays to play back
+    string strategy;               // Autopilot strategy; empty for the random player
+    long long batchGames = -1;     // Games in batch mode; -1 when not batching
+    int threads = (int)thread::hardware_concurrency();
+    bool levelGiven = false;
+    GameConfig config;             // Board size (--width, --height)
+    string levelsPath;             // Level pack to play instead of the built-in levels
+    string saveLevelsPath;         // Binary copy of the level pack to write
+    int mazes = 0;                 // Generated maze levels to play instead of the built-in levels
+    double difficulty = 0.5;       // Of the generated mazes
+    string scoresPath;             // Score log every finished game is added to
+    string checkpointPath;         // Snapshot of the run written every checkpointEvery ticks
+    long long checkpointEvery = 1000000;
+    string resumePath;             // Snapshot the run carries on from
+    int arenaSnakes = 0;           // Snakes in the arena; 0 when not running one
+    int arenaFood = -1;            // Food items in the arena; -1 for a quarter of the snakes
+
+    // Parse command line options
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) { maxTicks = atoll(argv[++i]); ticksGiven = true; }
+        else if (arg == "--level" && i + 1 < argc) { startLevel = atoi(argv[++i]); levelGiven = true; }
+        else if (arg == "--width" && i + 1 < argc) config.setSize(atoi(argv[++i]), config.height);
+        else if (arg == "--height" && i + 1 < argc) config.setSize(config.width, atoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--tick-ms" && i + 1 < argc) tickMs = max(0.0, atof(argv[++i]));
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc) replayPaths.push_back(argv[++i]);
+        else if (arg == "--autopilot" && i + 1 < argc && makeAutopilotStrategy(argv[i + 1])) strategy = argv[++i];
+        else if (arg == "--batch" && i + 1 < argc) batchGames = max(0LL, atoll(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--levels" && i + 1 < argc) levelsPath = argv[++i];
+        else if (arg == "--save-levels" && i + 1 < argc) saveLevelsPath = argv[++i];
+        else if (arg == "--mazes" && i + 1 < argc) mazes = max(0, atoi(argv[++i]));
+        else if (arg == "--difficulty" && i + 1 < argc) difficulty = atof(argv[++i]);
+        else if (arg == "--scores" && i + 1 < argc) scoresPath = argv[++i];
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpointPath = argv[++i];
+        else if (arg == "--checkpoint-every" && i + 1 < argc) checkpointEvery = max(1LL, atoll(argv[++i]));
+        else if (arg == "--resume" && i + 1 < argc) resumePath = argv[++i];
+        else if (arg == "--arena" && i + 1 < argc) arenaSnakes = max(0, atoi(argv[++i]));
+        else if (arg == "--arena-food" && i + 1 < argc) arenaFood = max(0, atoi(argv[++i]));
+        else {
+            cerr << "Usage: " << argv[0] << " [--ticks N] [--level L] [--seed S] [--tick-ms N] [--record FILE | --replay FILE]"
+                 << " [--autopilot bfs|astar|cycle] [--batch N] [--threads T] [--width W] [--height H]"
+                 << " [--levels FILE | --mazes N [--difficulty D]] [--save-levels FILE] [--scores FILE]"
+                 << " [--checkpoint FILE [--checkpoint-every N]] [--resume FILE] [--arena N [--arena-food F]]\n";
+            return 1;
+        }
+    }
+
+    // Every game of the run shares one level source, so each level is compiled once
+    unique_ptr<LevelSource> levels;
+    if (!levelsPath.empty()) {
+        unique_ptr<LevelPack> pack(new LevelPack());
+        string error;
+        if (!pack->open(levelsPath, error)) {
+            cerr << "Cannot load levels: " << error << "\n";
+            return 1;
+        }
+        if (!saveLevelsPath.empty()) {
+            if (!pack->saveBinary(saveLevelsPath, error)) {
+                cerr << "Cannot save levels: " << error << "\n";
+                return 1;
+            }
+            cout << "saved:          " << saveLevelsPath << " (" << pack->levelCount() << " levels)\n";
+            return 0;
+        }
+        levels = std::move(pack);
+    } else if (mazes > 0) {
+        MazeGenerator generator(config.width, config.height, difficulty);
+        MazeGenerator::Stats stats;
+        unique_ptr<GeneratedLevels> generated(new GeneratedLevels());
+        generated->layouts = generator.generate(mazes, seed, threads, &stats);
+        cout << "mazes:          " << mazes << " from " << stats.candidates << " candidates (" << stats.disconnected
+             << " disconnected, " << stats.trapped << " trapped) in " << fixed << setprecision(3) << stats.seconds
+             << " s, " << setprecision(0) << (stats.seconds > 0 ? stats.candidates / stats.seconds : 0.0)
+             << " candidates/sec\n";
+        if (!saveLevelsPath.empty()) {
+            if (!LevelPack::writeBinary(saveLevelsPath, generated->layouts)) {
+                cerr << "Cannot save levels: cannot write " << saveLevelsPath << "\n";
+                return 1;
+            }
+            cout << "saved:          " << saveLevelsPath << " (" << mazes << " levels)\n";
+            return 0;
+        }
+        levels = std::move(generated);
+    } else {
+        levels.reset(new BuiltinLevels(config.width, config.height));
+    }
+    if ((!levelsPath.empty() || mazes > 0) && !recordPath.empty()) {
+        cerr << "Replays are of the built-in levels only\n";
+        return 1;
+    }
+    int levelCount = levels->levelCount();
+    if (startLevel < 1 || startLevel > levelCount) startLevel = 1;
+    if (!levels->layout(startLevel)) {
+        cerr << "Cannot play: " << levels->layoutError(startLevel) << "\n";
+        return 1;
+    }
+    if (!strategy.empty()) {
+        for (int l = 1; l <= levelCount; l++) {
+            GameConfig size = config;
+            levels->boardSize(l, size.width, size.height);
+            if (autopilotSupports(size)) continue;
+            cerr << "The autopilot cannot play a " << size.width << "x" << size.height << " board\n";
+            return 1;
+        }
+    }
+    ScoreStore scores;
+    if (!scoresPath.empty()) {
+        string error;
+        if (!scores.open(scoresPath, error)) {
+            cerr << "Cannot open score log: " << error << "\n";
+            return 1;
+        }
+    }
+    bool checkpointing = !checkpointPath.empty() || !resumePath.empty();
+    if (checkpointing && (batchGames >= 0 || !replayPaths.empty() || !recordPath.empty())) {
+        cerr << "Checkpoints are of single runs, without replays\n";
+        return 1;
+    }
+    if (arenaSnakes > 0) {
+        if (checkpointing || batchGames >= 0 || !recordPath.empty() || scores.isOpen()) {
+            cerr << "The arena runs on its own, without batches, recording, checkpoints or scores\n";
+            return 1;
+        }
+        return runArena(levels->layout(startLevel), arenaSnakes, arenaFood < 0 ? max(1, arenaSnakes / 4) : arenaFood,
+                        seed, ticksGiven ? maxTicks : 1000, threads, replayPaths);
+    }
+    if (batchGames >= 0 || replayPaths.size() > 1) {
+        Rng seeds(seed);
+        vector<BatchJob> jobs;
+        for (long long i = 0; i < batchGames; i++)
+            jobs.push_back({seeds.next64(), levelGiven ? startLevel : 1 + (int)(i % levelCount), ""});
+        for (const string& path : replayPaths) jobs.push_back({0, 0, path});
+        int status = runBatch(jobs, config, levels.get(), strategy, maxTicks, threads, scores);
+        if (scores.isOpen()) printLeaderboard(scores, scoresPath);
+        return status;
+    }
+    if (!replayPaths.empty()) return playReplay(replayPaths[0]);
+    unique_ptr<Autopilot> autopilot; // Plays instead of the random player
+    if (!strategy.empty()) autopilot.reset(new Autopilot(makeAutopilotStrategy(strategy)));
+
+    Rng rng(seed); // Drives the random player and the seed of each session
+    long long ticks = 0, games = 0, fruits = 0, levelsCleared = 0, wins = 0;
+    Snapshot resume;
+    unique_ptr<Game> resumed; // Session the run carries on with (--resume)
+    if (!resumePath.empty()) {
+        string error;
+        if (resume.load(resumePath, error) && resume.driver.size() == 6)
+            resumed.reset(resume.restore(levels.get(), error));
+        if (!resumed) {
+            cerr << "Cannot resume: " << (error.empty() ? resumePath + " is not a checkpoint of a run" : error) << "\n";
+            return 1;
+        }
+        rng.state = resume.driver[0];
+        ticks = (long long)resume.driver[1];
+        games = (long long)resume.driver[2];
+        fruits = (long long)resume.driver[3];
+        levelsCleared = (long long)resume.driver[4];
+        wins = (long long)resume.driver[5];
+        cout << "resumed:        " << resumePath << " at tick " << ticks << "\n";
+    }
+    TickScheduler scheduler(chrono::duration_cast<TickScheduler::Clock::duration>(chrono::duration<double, milli>(tickMs)));
+    auto begin = chrono::steady_clock::now();
+
+    // Play sessions back to back until the tick budget is used up (only one when recording)
+    while (ticks < maxTicks) {
+        bool carriedOn = resumed != nullptr; // The checkpointed session, already counted in games
+        uint64_t sessionSeed = carriedOn ? resumed->seed : rng.next64();
+        int sessionStartLevel = carriedOn ? resume.startLevel : startLevel;
+        unique_ptr<Game> game(carriedOn ? resumed.release() : new Game(startLevel, sessionSeed, config, levels.get()));
+        ReplayRecorder recorder(sessionSeed, startLevel, config);
+        TurnBuffer turns;
+        long long sessionTicks = carriedOn ? resume.ticks : 0;
+        if (!carriedOn) games++;
+        auto sessionBegin = chrono::steady_clock::now();
+        // Saves the run as it stands: the session plus what the run has counted so far
+        auto checkpoint = [&] {
+            Snapshot snapshot = Snapshot::capture(*game, sessionStartLevel, sessionTicks, 0);
+            snapshot.driver = {rng.state, (uint64_t)ticks, (uint64_t)games, (uint64_t)fruits, (uint64_t)levelsCleared,
+                               (uint64_t)wins};
+            string error;
+            if (!snapshot.save(checkpointPath, error)) cerr << "Cannot write checkpoint: " << error << "\n";
+        };
+        while (!game->over && !game->won && ticks < maxTicks) {
+            scheduler.waitForNextTick();
+            char turn = autopilot ? autopilotTurn(*autopilot, turns, *game->board) : randomTurn(rng);
+            if (!recordPath.empty()) recorder.record(turn);
+            int events = game->step(turn);
+            ticks++;
+            sessionTicks++;
+            if (events & EVENT_ATE_FOOD) fruits++;
+            if (events & EVENT_LEVEL_CLEARED) {
+                levelsCleared++;
+                turns.clear(); // Turns planned for the old board don't carry over
+            }
+            if (events & EVENT_GAME_WON) wins++;
+            if (!checkpointPath.empty() && !game->over && (ticks % checkpointEvery == 0 || ticks == maxTicks)) checkpoint();
+        }
+        if (!game->error.empty()) {
+            cerr << "Cannot play on: " << game->error << "\n";
+            return 1;
+        }
+        if (game->over && scores.isOpen()) {
+            long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - sessionBegin).count();
+            scores.add(RunRecord::of(*game, sessionStartLevel, sessionTicks, (uint32_t)ms));
+        }
+        if (!recordPath.empty()) {
+            recorder.finish(*game);
+            if (!recorder.save(recordPath)) {
+                cerr << "Cannot write replay " << recordPath << "\n";
+                return 1;
+            }
+            cout << "recorded:       " << recordPath << " (" << recorder.bytes.size() << " bytes, final state "
+                 << hex << hashGame(*game) << dec << ")\n";
+            break;
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "ticks:          " << ticks << "\n";
+    cout << "games:          " << games << "\n";
+    cout << "fruits:         " << fruits << "\n";
+    cout << "levels cleared: " << levelsCleared << "\n";
+    cout << "games won:      " << wins << "\n";
+    cout << "seconds:        " << fixed << setprecision(3) << seconds << "\n";
+    cout << "ticks/sec:      " << fixed << setprecision(0) << (seconds > 0 ? ticks / seconds : 0.0) << "\n";
+    if (tickMs > 0) {
+        cout << "late ticks:     " << scheduler.overruns << " (avg " << setprecision(3) << scheduler.averageOverrunMs()
+             << " ms, max " << scheduler.maxOverrunMs() << " ms)\n";
+    }
+    if (autopilot) {
+        cout << "autopilot:      " << autopilot->strategy->name() << ", " << autopilot->plans << " plans, avg "
+             << setprecision(0) << autopilot->totalPlanNs / max(1LL, autopilot->plans) << " ns, max "
+             << autopilot->maxPlanNs << " ns per tick\n";
+    }
+    if (scores.isOpen()) printLeaderboard(scores, scoresPath);
+    return 0;
+}
@@ -0,0 +1,341 @@
+// Snapshot.h
+// The complete state of a session in one small binary file, so a game can be quit and picked up
+// again exactly where it stopped, and a long headless run can checkpoint and restart. A restored
+// session plays on identically to one that was never interrupted: the snapshot holds the
+// snake's body, direction and growth, the food and whether it is a money fruit, the level's
+// score and fruit count, the session's money and level, both random generators, and the order
+// of the free cell index (food is drawn from it by position). Walls are not stored: the level
+// is rebuilt from the level source, and a fingerprint of its cells makes sure it is the same.
+//
+// Snapshots are written to a temporary file and renamed over the old one, so a crash leaves
+// either the previous snapshot or the new one, and are read back through a memory mapping.
+//
+// File form (integers little-endian, fixed size):
+//   "SNKV" magic (4 bytes), version (1 byte)
+//   board width, height, fruits to clear a level (4 each)
+//   session: seed (8), generator state (8), start level (4), level (4), money (4),
+//            score of cleared levels (4), flags (1: bit 0 = over, bit 1 = won)
+//   level fingerprint (8)
+//   board: generator state (8), food x, y (4 each), flags (1: bit 0 = has food, bit 1 = money
+//          fruit, bit 2 = tail vacated), score (4), fruits (4), last tail x, y (4 each)
+//   snake: direction (1), pending growth (4), length (4), segments tail to head (x, y: 4 each)
+//   free cell index: count (4), cells (4 each; standard boards only, 0 on chunked boards)
+//   ticks played (8), elapsed milliseconds (8)
+//   driver values: count (4), values (8 each)
+//   CRC-32 of everything before it (4)
+#pragma once
+
+#include <cstdint>     // For the fields
+#include <cstring>     // For memcmp
+#include <string>      // For paths and errors
+#include <vector>      // For the body and the encoded bytes
+#include "SnakeCore.h" // Game, Board, Snake, LevelSource
+#include "FileIO.h"    // MappedFile, CRC-32, atomic file replacement
+
+#define SNAPSHOT_VERSION 1
+
+// --- Snapshot ---
+struct Snapshot {
+    GameConfig config;              // Board size and level goal of the session
+    uint64_t seed = 0;              // Game::seed
+    uint64_t gameRng = 0;           // Game::rng, which seeds the next levels' boards
+    int startLevel = 1;             // Level the session started on
+    int level = 1;                  // Level being played
+    int money = 0;                  // Game::totalMoneyCollected
+    int clearedScore = 0;           // Game::clearedScore
+    bool over = false, won = false;
+    uint64_t fingerprint = 0;       // Of the level's layout
+    uint64_t boardRng = 0;          // Board::rng, which places the food
+    Point food;
+    bool hasFood = false, isMoneyFruit = false, tailVacated = false;
+    int score = 0, fruitCount = 0;  // Of the level being played
+    Point lastTail;
+    char direction = DIR_RIGHT;
+    int pendingGrowth = 0;
+    std::vector<Point> body;        // Segments, tail first
+    std::vector<int> freeOrder;     // Board::grid.freeCells.cells (standard boards)
+    long long ticks = 0;            // Ticks the session has played
+    long long elapsedMs = 0;        // Time the session has been played
+    std::vector<uint64_t> driver;   // Values the program running the game keeps with it (its own
+                                    // generators, counters); not interpreted here
+
+    // Takes the state of a session
+    static Snapshot capture(const Game& game, int startLevel, long long ticks, long long elapsedMs) {
+        Snapshot s;
+        const Board& b = *game.board;
+        s.config = game.config;
+        s.seed = game.seed;
+        s.gameRng = game.rng.state;
+        s.startLevel = startLevel;
+        s.level = game.currentLevel;
+        s.money = game.totalMoneyCollected;
+        s.clearedScore = game.clearedScore;
+        s.over = game.over;
+        s.won = game.won;
+        s.fingerprint = fingerprintOf(*b.layout);
+        s.boardRng = b.rng.state;
+        s.food = b.food;
+        s.hasFood = b.hasFood;
+        s.isMoneyFruit = b.isMoneyFruit;
+        s.tailVacated = b.tailVacated;
+        s.score = b.score;
+        s.fruitCount = b.fruitCount;
+        s.lastTail = b.lastTail;
+        s.direction = b.snake->direction;
+        s.pendingGrowth = b.snake->pendingGrowth;
+        for (int i = b.snake->length - 1; i >= 0; i--) s.body.push_back(b.snake->segment(i));
+        if (!b.grid.chunked) s.freeOrder = b.grid.freeCells.cells;
+        s.ticks = ticks;
+        s.elapsedMs = elapsedMs;
+        return s;
+    }
+
+    // Builds the session again, with the level from levels (nullptr for the built-in levels,
+    // as for Game). Returns a new Game the caller owns, or nullptr with a message in error if
+    // the level is not the one the snapshot was taken on or the snapshot contradicts itself.
+    Game* restore(LevelSource* levels, std::string& error) const {
+        if (level < 1 || (levels && level > levels->levelCount()) || (!levels && level > MAX_LEVEL) || body.empty()) {
+            error = "snapshot is of a level that does not exist";
+            return nullptr;
+        }
+        if (levels && !levels->layout(level)) {
+            error = levels->layoutError(level);
+            return nullptr;
+        }
+        Game* game = new Game(level, seed, config, levels);
+        Board& b = *game->board;
+        if (fingerprintOf(*b.layout) != fingerprint) {
+            delete game;
+            error = "snapshot was taken on a different level";
+            return nullptr;
+        }
+        game->rng.state = gameRng;
+        game->totalMoneyCollected = money;
+        game->clearedScore = clearedScore;
+        game->over = over;
+        game->won = won;
+
+        // The snake, then the grid: the level's cells with the body and food put back
+        Snake& snake = *b.snake;
+        int capacity = 16;
+        while (capacity < 2 * (int)body.size()) capacity *= 2;
+        snake.ring.assign(capacity, Point());
+        for (size_t i = 0; i < body.size(); i++) snake.ring[i] = body[i];
+        snake.tailIndex = 0;
+        snake.headIndex = (int)body.size() - 1;
+        snake.length = (int)body.size();
+        snake.pendingGrowth = pendingGrowth;
+        snake.direction = direction;
+        b.grid = OccupancyGrid(*b.layout);
+        snake.place(b.grid);
+        b.food = food;
+        b.hasFood = hasFood;
+        if (hasFood) {
+            if (b.grid.get(food) != CELL_EMPTY) {
+                delete game;
+                error = "snapshot food is not on a free cell";
+                return nullptr;
+            }
+            b.grid.set(food, CELL_FOOD);
+        }
+        if (!b.grid.chunked) { // Food is drawn by position in the index, so its order must match too
+            FreeCellIndex& index = b.grid.freeCells;
+            bool same = (int)freeOrder.size() == index.size();
+            std::vector<char> seen(index.position.size(), 0);
+            for (size_t i = 0; same && i < freeOrder.size(); i++) {
+                int cell = freeOrder[i];
+                same = cell >= 0 && cell < (int)seen.size() && index.contains(cell) && !seen[cell];
+                if (same) seen[cell] = 1;
+            }
+            if (!same) {
+                delete game;
+                error = "snapshot free cells do not match the board";
+                return nullptr;
+            }
+            index.cells = freeOrder;
+            for (size_t i = 0; i < freeOrder.size(); i++) index.position[freeOrder[i]] = (int)i;
+        }
+        b.rng.state = boardRng;
+        b.isMoneyFruit = isMoneyFruit;
+        b.score = score;
+        b.fruitCount = fruitCount;
+        b.lastTail = lastTail;
+        b.tailVacated = tailVacated;
+        return game;
+    }
+
+    // Encodes the snapshot in the file form
+    std::vector<uint8_t> encode() const {
+        std::vector<uint8_t> out = {'S', 'N', 'K', 'V', SNAPSHOT_VERSION};
+        put(out, (uint32_t)config.width, 4);
+        put(out, (uint32_t)config.height, 4);
+        put(out, (uint32_t)config.fruitsToClearLevel, 4);
+        put(out, seed, 8);
+        put(out, gameRng, 8);
+        put(out, (uint32_t)startLevel, 4);
+        put(out, (uint32_t)level, 4);
+        put(out, (uint32_t)money, 4);
+        put(out, (uint32_t)clearedScore, 4);
+        put(out, (over ? 1 : 0) | (won ? 2 : 0), 1);
+        put(out, fingerprint, 8);
+        put(out, boardRng, 8);
+        put(out, (uint32_t)food.x, 4);
+        put(out, (uint32_t)food.y, 4);
+        put(out, (hasFood ? 1 : 0) | (isMoneyFruit ? 2 : 0) | (tailVacated ? 4 : 0), 1);
+        put(out, (uint32_t)score, 4);
+        put(out, (uint32_t)fruitCount, 4);
+        put(out, (uint32_t)lastTail.x, 4);
+        put(out, (uint32_t)lastTail.y, 4);
+        put(out, (uint8_t)direction, 1);
+        put(out, (uint32_t)pendingGrowth, 4);
+        put(out, body.size(), 4);
+        for (const Point& p : body) {
+            put(out, (uint32_t)p.x, 4);
+            put(out, (uint32_t)p.y, 4);
+        }
+        put(out, freeOrder.size(), 4);
+        for (int cell : freeOrder) put(out, (uint32_t)cell, 4);
+        put(out, (uint64_t)ticks, 8);
+        put(out, (uint64_t)elapsedMs, 8);
+        put(out, driver.size(), 4);
+        for (uint64_t v : driver) put(out, v, 8);
+        put(out, crc32(out.data(), out.size()), 4);
+        return out;
+    }
+
+    // Decodes the file form; returns false with a message in error if it is not a snapshot,
+    // is of a later version, or is damaged
+    bool decode(const uint8_t* data, size_t size, std::string& error) {
+        if (size < 9 || memcmp(data, "SNKV", 4) != 0) {
+            error = "not a snapshot";
+            return false;
+        }
+        if (data[4] > SNAPSHOT_VERSION) {
+            error = "unsupported snapshot version";
+            return false;
+        }
+        uint32_t crc = (uint32_t)get(data + size - 4, 4);
+        if (crc != crc32(data, size - 4)) {
+            error = "snapshot is damaged";
+            return false;
+        }
+        Reader in{data, size - 4, 5};
+        config.width = in.i32();
+        config.height = in.i32();
+        config.fruitsToClearLevel = in.i32();
+        seed = in.u(8);
+        gameRng = in.u(8);
+        startLevel = in.i32();
+        level = in.i32();
+        money = in.i32();
+        clearedScore = in.i32();
+        uint64_t flags = in.u(1);
+        over = (flags & 1) != 0;
+        won = (flags & 2) != 0;
+        fingerprint = in.u(8);
+        boardRng = in.u(8);
+        food.x = in.i32();
+        food.y = in.i32();
+        flags = in.u(1);
+        hasFood = (flags & 1) != 0;
+        isMoneyFruit = (flags & 2) != 0;
+        tailVacated = (flags & 4) != 0;
+        score = in.i32();
+        fruitCount = in.i32();
+        lastTail.x = in.i32();
+        lastTail.y = in.i32();
+        direction = (char)in.u(1);
+        pendingGrowth = in.i32();
+        uint64_t count = in.u(4);
+        body.clear();
+        for (uint64_t i = 0; i < count && in.ok; i++) {
+            Point p;
+            p.x = in.i32();
+            p.y = in.i32();
+            body.push_back(p);
+        }
+        count = in.u(4);
+        freeOrder.clear();
+        for (uint64_t i = 0; i < count && in.ok; i++) freeOrder.push_back(in.i32());
+        ticks = (long long)in.u(8);
+        elapsedMs = (long long)in.u(8);
+        count = in.u(4);
+        driver.clear();
+        for (uint64_t i = 0; i < count && in.ok; i++) driver.push_back(in.u(8));
+        if (!in.ok || in.pos != in.size) {
+            error = "snapshot is damaged";
+            return false;
+        }
+        GameConfig clamped;
+        clamped.setSize(config.width, config.height);
+        if (clamped.width != config.width || clamped.height != config.height) {
+            error = "snapshot board size is out of range";
+            return false;
+        }
+        return true;
+    }
+
+    // Writes the snapshot, replacing any earlier one at path in one step
+    bool save(const std::string& path, std::string& error) const {
+        if (!writeFileAtomically(path, encode())) {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // Reads a snapshot file
+    bool load(const std::string& path, std::string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = "cannot read " + path;
+            return false;
+        }
+        if (!decode((const uint8_t*)file.data(), file.size(), error)) {
+            error = path + ": " + error;
+            return false;
+        }
+        return true;
+    }
+
+    // FNV-1a over a level's size, start and cells
+    static uint64_t fingerprintOf(const LevelLayout& layout) {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](uint64_t v) {
+            h ^= v;
+            h *= 1099511628211ULL;
+        };
+        mix((uint64_t)layout.width);
+        mix((uint64_t)layout.height);
+        mix((uint64_t)layout.startX);
+        mix((uint64_t)layout.startY);
+        for (unsigned char c : layout.cells) mix(c);
+        return h;
+    }
+
+private:
+    static void put(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int b = 0; b < bytes; b++) out.push_back((uint8_t)(value >> (8 * b)));
+    }
+    static uint64_t get(const uint8_t* p, int bytes) {
+        uint64_t value = 0;
+        for (int b = 0; b < bytes; b++) value |= (uint64_t)p[b] << (8 * b);
+        return value;
+    }
+
+    // Reads fields in order; ok turns false instead of reading past the end
+    struct Reader {
+        const uint8_t* data;
+        size_t size, pos;
+        bool ok = true;
+        uint64_t u(int bytes) {
+            if (!ok || size - pos < (size_t)bytes) {
+                ok = false;
+                return 0;
+            }
+            pos += bytes;
+            return get(data + pos - bytes, bytes);
+        }
+        int i32() { return (int)(int32_t)u(4); }
+    };
+};
@@ -0,0 +1,221 @@
+// SoundEngine.h
+// Plays sounds on a background mixer thread so the game thread never waits for the speaker.
+// The game thread posts SoundEvents to a lock-free queue (a full queue drops the sound rather
+// than blocking); the mixer picks them up, synthesizes each as a tone with a short fade in and
+// out, mixes overlapping tones into 16-bit mono PCM and hands the blocks to a SoundSink.
+// Sinks decide where sound goes: nowhere (NullSoundSink, for headless runs), a WAV file
+// (WavSoundSink, for checking the output on machines without audio hardware), or a device.
+// A sink that cannot take PCM (e.g. the PC speaker) receives the events themselves instead.
+#pragma once
+
+#include <algorithm> // For std::min and std::max
+#include <atomic>    // For the stop flag and counters
+#include <chrono>    // For pacing the mixer in real time
+#include <cmath>     // For the tone generator
+#include <cstdint>   // For PCM samples
+#include <cstdio>    // For the WAV file
+#include <memory>    // For owning the sink
+#include <string>    // For the WAV path
+#include <thread>    // For the mixer thread
+#include <vector>    // For the mix buffers and active voices
+#include "SpscQueue.h" // Game thread -> mixer thread
+
+// --- Sound Events ---
+struct SoundEvent {
+    int frequency;  // Hz
+    int durationMs; // Length of the tone
+    float volume;   // 0..1 of full scale
+};
+
+// --- Sinks ---
+class SoundSink {
+public:
+    virtual ~SoundSink() {}
+
+    // True if the sink takes PCM through write(); false if it plays events through play()
+    virtual bool wantsPcm() const { return true; }
+
+    // Receives the next block of mixed samples (called on the mixer thread)
+    virtual void write(const int16_t*, size_t) {}
+
+    // Plays one event directly (called on the mixer thread, for sinks that don't take PCM)
+    virtual void play(const SoundEvent&) {}
+};
+
+// Discards everything; counts the samples so tests can see the mixer ran
+class NullSoundSink : public SoundSink {
+public:
+    std::atomic<long long> samples{0};
+
+    void write(const int16_t*, size_t count) override { samples += (long long)count; }
+};
+
+// Writes the PCM stream to a 16-bit mono WAV file. The sizes in the header are filled in when
+// the sink is destroyed.
+class WavSoundSink : public SoundSink {
+public:
+    WavSoundSink(const std::string& path, int sampleRate) : sampleRate(sampleRate), dataBytes(0) {
+        file = fopen(path.c_str(), "wb");
+        if (file) writeHeader();
+    }
+
+    ~WavSoundSink() override {
+        if (!file) return;
+        fseek(file, 0, SEEK_SET);
+        writeHeader(); // Now with the real sizes
+        fclose(file);
+    }
+
+    WavSoundSink(const WavSoundSink&) = delete;
+    WavSoundSink& operator=(const WavSoundSink&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const int16_t* pcm, size_t count) override {
+        if (!file) return;
+        bytes.resize(count * 2);
+        for (size_t i = 0; i < count; i++) { // Little-endian samples whatever the host order
+            bytes[2 * i] = (unsigned char)(pcm[i] & 0xFF);
+            bytes[2 * i + 1] = (unsigned char)((uint16_t)pcm[i] >> 8);
+        }
+        fwrite(bytes.data(), 1, bytes.size(), file);
+        dataBytes += (uint32_t)bytes.size();
+    }
+
+private:
+    FILE* file;
+    int sampleRate;
+    uint32_t dataBytes; // PCM bytes written so far
+    std::vector<unsigned char> bytes; // One block in file byte order
+
+    void put32(uint32_t v) {
+        unsigned char b[4] = {(unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24)};
+        fwrite(b, 1, 4, file);
+    }
+    void put16(uint16_t v) {
+        unsigned char b[2] = {(unsigned char)v, (unsigned char)(v >> 8)};
+        fwrite(b, 1, 2, file);
+    }
+
+    void writeHeader() {
+        fwrite("RIFF", 1, 4, file);
+        put32(36 + dataBytes);
+        fwrite("WAVEfmt ", 1, 8, file);
+        put32(16);                      // Size of the format chunk
+        put16(1);                       // PCM
+        put16(1);                       // Mono
+        put32((uint32_t)sampleRate);
+        put32((uint32_t)sampleRate * 2); // Bytes per second
+        put16(2);                       // Bytes per sample frame
+        put16(16);                      // Bits per sample
+        fwrite("data", 1, 4, file);
+        put32(dataBytes);
+    }
+};
+
+// --- Sound Engine ---
+class SoundEngine {
+public:
+    std::atomic<long long> dropped{0}; // Sounds lost because the queue was full
+
+    // Starts the mixer thread. In real time the mixer produces one block every BLOCK_MS, with
+    // silence between sounds (what a device or a WAV recording of a session needs); otherwise
+    // it renders each sound as soon as it arrives and writes nothing in between.
+    SoundEngine(std::unique_ptr<SoundSink> sink, int sampleRate = 22050, bool realTime = true)
+        : sink(std::move(sink)), sampleRate(sampleRate), realTime(realTime), running(true),
+          mixer([this] { run(); }) {}
+
+    // Finishes the sounds already queued, then stops the mixer
+    ~SoundEngine() {
+        running = false;
+        mixer.join();
+    }
+
+    SoundEngine(const SoundEngine&) = delete;
+    SoundEngine& operator=(const SoundEngine&) = delete;
+
+    // Queues a tone. Never blocks: if the mixer has fallen far behind, the sound is dropped.
+    void play(int frequency, int durationMs, float volume = 0.5f) {
+        if (!events.tryPush(SoundEvent{frequency, durationMs, volume})) dropped++;
+    }
+
+private:
+    static const int BLOCK_MS = 10; // Mixer block length
+    static const int FADE_MS = 5;   // Fade in and out of each tone, to avoid clicks
+    static constexpr double TWO_PI = 6.283185307179586;
+
+    struct Voice {
+        double phase, step; // Oscillator phase and increment per sample (radians)
+        long long position; // Samples played so far
+        long long length;   // Samples in the tone
+        long long fade;     // Samples of fade at each end
+        double amplitude;   // Peak sample value
+    };
+
+    std::unique_ptr<SoundSink> sink;
+    int sampleRate;
+    bool realTime;
+    SpscQueue<SoundEvent, 64> events; // Written by the game thread, read by the mixer
+    std::atomic<bool> running;
+    std::vector<Voice> voices;        // Tones being played (mixer thread only)
+    std::thread mixer;                // Declared last so it starts after the other members are ready
+
+    void start(const SoundEvent& e) {
+        Voice v;
+        v.phase = 0;
+        v.step = TWO_PI * e.frequency / sampleRate;
+        v.position = 0;
+        v.length = (long long)e.durationMs * sampleRate / 1000;
+        v.fade = std::min((long long)FADE_MS * sampleRate / 1000, v.length / 2);
+        v.amplitude = 32767.0 * std::max(0.0f, std::min(1.0f, e.volume));
+        voices.push_back(v);
+    }
+
+    // Mixes count samples of every active voice into out and retires finished voices
+    void mix(std::vector<int16_t>& out, size_t count) {
+        std::vector<int> sum(count, 0);
+        for (Voice& v : voices) {
+            for (size_t i = 0; i < count && v.position < v.length; i++, v.position++) {
+                long long edge = std::min(v.position, v.length - 1 - v.position);
+                double gain = edge < v.fade ? (double)edge / v.fade : 1.0;
+                sum[i] += (int)(v.amplitude * gain * std::sin(v.phase));
+                v.phase += v.step;
+                if (v.phase > TWO_PI) v.phase -= TWO_PI;
+            }
+        }
+        size_t kept = 0;
+        for (Voice& v : voices)
+            if (v.position < v.length) voices[kept++] = v;
+        voices.resize(kept);
+        out.resize(count);
+        for (size_t i = 0; i < count; i++) out[i] = (int16_t)std::max(-32768, std::min(32767, sum[i]));
+    }
+
+    void run() {
+        const size_t block = (size_t)sampleRate * BLOCK_MS / 1000;
+        std::vector<int16_t> pcm;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+        while (true) {
+            bool stopping = !running; // Read before draining, so nothing queued earlier is missed
+            SoundEvent e;
+            while (events.tryPop(e)) {
+                if (sink->wantsPcm()) start(e);
+                else sink->play(e);
+            }
+            if (stopping && voices.empty()) return;
+
+            if (!sink->wantsPcm() || (!realTime && voices.empty())) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(BLOCK_MS)); // Nothing to render
+                continue;
+            }
+            mix(pcm, block);
+            sink->write(pcm.data(), pcm.size());
+            if (realTime) {
+                deadline += std::chrono::milliseconds(BLOCK_MS);
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (now - deadline > std::chrono::milliseconds(10 * BLOCK_MS)) deadline = now; // Fell far behind: resync
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    }
+};
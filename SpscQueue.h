@@ -0,0 +1,43 @@
+// SpscQueue.h
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Used to hand input commands and sound events between threads without blocking:
+// a full queue makes tryPush() fail instead of waiting.
+#pragma once
+
+#include <atomic>  // For the head and tail counters
+#include <cstddef> // For size_t
+
+// --- Single-Producer Single-Consumer Queue ---
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Called by the producer only. Returns false (dropping the item) if the queue is full.
+    bool tryPush(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        slots[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release); // Publish the slot to the consumer
+        return true;
+    }
+
+    // Called by the consumer only. Returns false if the queue is empty.
+    bool tryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = slots[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release); // Hand the slot back to the producer
+        return true;
+    }
+
+    // Approximate number of queued items (exact when called from either end while the other is idle)
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+    T slots[Capacity];
+    alignas(64) std::atomic<size_t> head{0}; // Next slot to pop (written by the consumer)
+    alignas(64) std::atomic<size_t> tail{0}; // Next slot to push (written by the producer)
+};
@@ -0,0 +1,67 @@
+// TickScheduler.h
+// Fixed-timestep scheduler driven by std::chrono::steady_clock (wall time, never adjusted).
+// Each tick's deadline is the previous deadline plus the period, so the time spent updating
+// and drawing is absorbed instead of added to the tick length, and the loop does not drift.
+// A period of zero runs uncapped (headless mode). Ticks that start late are counted as
+// overruns; a loop that falls far behind is resynchronised rather than allowed to burst.
+#pragma once
+
+#include <chrono> // For steady_clock
+#include <thread> // For sleep_until
+
+// --- Tick Scheduler Class ---
+class TickScheduler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::duration period;         // Default tick length (zero = uncapped)
+    Clock::time_point lastDeadline; // Deadline of the most recent tick
+    long long ticks;                // Ticks scheduled so far
+    long long overruns;             // Ticks that started after their deadline
+    Clock::duration maxOverrun;     // Worst lateness seen
+    Clock::duration totalOverrun;   // Sum of all lateness, for the average
+    int maxCatchUpTicks;            // A tick later than this many periods resets the schedule
+
+    // Constructor: Starts the schedule now with the given tick length
+    TickScheduler(Clock::duration period = Clock::duration::zero())
+        : period(period), ticks(0), overruns(0), maxOverrun(Clock::duration::zero()),
+          totalOverrun(Clock::duration::zero()), maxCatchUpTicks(3) {
+        reset();
+    }
+
+    // Restarts the schedule from the current time (after a pause or a blocking banner)
+    void reset() { lastDeadline = Clock::now(); }
+
+    // Waits for the deadline of the next tick using the default period
+    void waitForNextTick() { waitForNextTick(period); }
+
+    // Waits until lastDeadline + tickPeriod, the start of the next tick. A tick whose
+    // deadline has already passed starts immediately and is recorded as an overrun.
+    void waitForNextTick(Clock::duration tickPeriod) {
+        ticks++;
+        if (tickPeriod <= Clock::duration::zero()) return; // Uncapped: no waiting, no lateness
+
+        Clock::time_point deadline = lastDeadline + tickPeriod;
+        Clock::time_point now = Clock::now();
+        if (now < deadline) {
+            std::this_thread::sleep_until(deadline);
+            lastDeadline = deadline;
+            return;
+        }
+
+        Clock::duration late = now - deadline;
+        if (late > Clock::duration::zero()) {
+            overruns++;
+            totalOverrun += late;
+            if (late > maxOverrun) maxOverrun = late;
+        }
+        // Keep the original cadence for small slips; start over if hopelessly behind
+        lastDeadline = late > tickPeriod * maxCatchUpTicks ? now : deadline;
+    }
+
+    // Lateness statistics in milliseconds
+    double maxOverrunMs() const { return std::chrono::duration<double, std::milli>(maxOverrun).count(); }
+    double averageOverrunMs() const {
+        return overruns ? std::chrono::duration<double, std::milli>(totalOverrun).count() / overruns : 0.0;
+    }
+};
@@ -0,0 +1,94 @@
+// TimerWheel.h
+// Hashed timer wheel for timed events in the game loop (overlays that disappear after a while,
+// a banner that follows another). Time is divided into slots of slotMs milliseconds and each
+// timer is kept in the slot its deadline falls into, modulo the wheel size, so scheduling and
+// cancelling are O(1) and advance() only looks at the slots that time has passed through.
+// Nothing here sleeps or reads a clock: the caller passes the current time to advance(), so
+// the loop around it keeps running and a driver without a screen can set skipDelays to let
+// every timer fire on the next advance() instead of waiting for it.
+#pragma once
+
+#include <algorithm>     // For std::sort
+#include <cstdint>       // For timer ids
+#include <functional>    // For the callbacks
+#include <unordered_map> // For finding a timer's slot by id
+#include <vector>        // For the slots
+
+class TimerWheel {
+public:
+    typedef std::function<void()> Callback;
+
+    bool skipDelays = false; // True: every timer is due at once, whatever its delay
+
+    TimerWheel(int slotMs = 10, int slotCount = 256) : slotMs(slotMs), slots(slotCount), lastSlot(0), nextId(1) {}
+
+    // Runs fn once delayMs after the time of the last advance() (to within one slot; a delay of
+    // zero fires on the next advance()). Returns an id for cancel().
+    uint64_t schedule(long long delayMs, Callback fn) {
+        long long ticks = skipDelays || delayMs <= 0 ? 0 : (delayMs + slotMs - 1) / slotMs;
+        long long due = lastSlot + ticks;
+        uint64_t id = nextId++;
+        slots[due % slots.size()].push_back(Timer{id, due, std::move(fn)});
+        dueSlot[id] = due;
+        return id;
+    }
+
+    // Removes a timer that has not fired yet; returns false if there is none with this id
+    bool cancel(uint64_t id) {
+        auto it = dueSlot.find(id);
+        if (it == dueSlot.end()) return false;
+        std::vector<Timer>& slot = slots[it->second % slots.size()];
+        for (size_t i = 0; i < slot.size(); i++) {
+            if (slot[i].id != id) continue;
+            if (i + 1 < slot.size()) slot[i] = std::move(slot.back());
+            slot.pop_back();
+            break;
+        }
+        dueSlot.erase(it);
+        return true;
+    }
+
+    // Drops every pending timer
+    void clear() {
+        for (std::vector<Timer>& slot : slots) slot.clear();
+        dueSlot.clear();
+    }
+
+    size_t pending() const { return dueSlot.size(); }
+
+    // Moves the wheel to nowMs and runs every timer that is due, earliest deadline first.
+    // Timers scheduled by those callbacks are due at the next advance() at the earliest.
+    void advance(long long nowMs) {
+        long long target = std::max(lastSlot, nowMs / slotMs);
+        long long first = std::max(lastSlot, target - (long long)slots.size() + 1); // Visit each slot once
+        std::vector<Timer> due;
+        for (long long s = first; s <= target; s++) {
+            std::vector<Timer>& slot = slots[s % slots.size()];
+            for (size_t i = 0; i < slot.size();) {
+                if (slot[i].due > target) { i++; continue; } // A later turn of the wheel
+                due.push_back(std::move(slot[i]));
+                if (i + 1 < slot.size()) slot[i] = std::move(slot.back());
+                slot.pop_back();
+            }
+        }
+        lastSlot = target;
+        std::sort(due.begin(), due.end(), [](const Timer& a, const Timer& b) {
+            return a.due != b.due ? a.due < b.due : a.id < b.id;
+        });
+        for (Timer& t : due) dueSlot.erase(t.id);
+        for (Timer& t : due) t.fn();
+    }
+
+private:
+    struct Timer {
+        uint64_t id;
+        long long due; // Slot number the deadline falls into
+        Callback fn;
+    };
+
+    int slotMs;                                      // Length of a slot
+    std::vector<std::vector<Timer>> slots;           // Timers by deadline slot, modulo the wheel size
+    long long lastSlot;                              // Slot of the last advance(); earlier ones are empty
+    uint64_t nextId;
+    std::unordered_map<uint64_t, long long> dueSlot; // Pending timers: id -> deadline slot
+};
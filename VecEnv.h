@@ -0,0 +1,315 @@
+// VecEnv.h
+// Batch environment for training agents: N games of one level stepped in lockstep through a
+// Gym-style reset()/step(actions) interface. The state is kept as structure-of-arrays (head,
+// tail, direction, length, food, done as parallel arrays), so the per-tick decisions of
+// Snake::move (turn, next head, wall/body collision, food check) run eight games at a time
+// with AVX2 (scalar fallback). Only the writes that differ per game (the body ring, the
+// occupancy bits, the next fruit) are done game by game.
+//
+// Observations are written straight into a buffer the caller owns: one byte per cell (an
+// ObservationCell), games one after another, width * height bytes each. reset() fills it and
+// step() only rewrites the cells that changed, so no frame is ever copied.
+//
+// Rules are those of Board::step on a standard-size board, with two differences: food is
+// placed by each game's own generator (uniform over free cells, not Board's sequence), and a
+// game ends (done) when it dies or clears the level. A game that is done is restarted at the
+// beginning of the next step() with a new seed from its generator.
+#pragma once
+
+#include <cstdint> // For the packed state arrays
+#include <cstring> // For memcpy of the wall templates
+#include <vector>  // For the arrays
+#include "SnakeCore.h" // GameConfig, isLevelWall, Rng, MAX_LEVEL
+#ifdef __AVX2__
+#include <immintrin.h> // For the eight-wide step kernel
+#endif
+
+class VecEnv {
+public:
+    // Actions; anything else (e.g. -1) keeps the current direction. Reversals are ignored.
+    enum { ACTION_UP, ACTION_DOWN, ACTION_LEFT, ACTION_RIGHT };
+
+    // Observation bytes
+    enum ObservationCell { OBS_EMPTY, OBS_WALL, OBS_BODY, OBS_HEAD, OBS_FOOD };
+
+    // Rewards per step
+    static constexpr float REWARD_FRUIT = 1.0f; // Money fruits give 3x
+    static constexpr float REWARD_DEATH = -1.0f;
+
+    int count, level, width, height;
+    GameConfig config;
+
+    // Per-game state, indexed by game
+    std::vector<int32_t> headX, headY, tailX, tailY; // Head and tail cells (tail may start off the board)
+    std::vector<int32_t> direction;                  // ACTION_* code of the last move
+    std::vector<int32_t> length, pendingGrowth;
+    std::vector<int32_t> foodX, foodY;               // -1 when the board is full
+    std::vector<int32_t> score, fruitCount, ticks;   // Ticks since the game's last reset
+    std::vector<uint8_t> done;
+    std::vector<Rng> rng;                            // Food placement and restart seeds
+
+    // Builds count games of the given level; call reset() before step()
+    VecEnv(int count, int level, const GameConfig& config = GameConfig())
+        : count(count), level(level < 1 ? 1 : level > MAX_LEVEL ? MAX_LEVEL : level), width(config.width),
+          height(config.height), config(config), observations(nullptr) {
+        for (std::vector<int32_t>* a : {&headX, &headY, &tailX, &tailY, &direction, &length, &pendingGrowth, &foodX,
+                                        &foodY, &score, &fruitCount, &ticks, &nextX, &nextY, &outcome})
+            a->assign(count, 0);
+        done.assign(count, 0);
+        rng.resize(count);
+
+        // Occupancy: 32-bit words per row, walls and the padding past the last column set
+        rowWords = (width + 31) / 32;
+        gameWords = height * rowWords;
+        wallWords.assign(gameWords, 0);
+        wallCells.assign((size_t)width * height, OBS_EMPTY);
+        freeCells = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < rowWords * 32; x++) {
+                if (x < width && !isLevelWall(x, y, this->level, width, height)) {
+                    freeCells++;
+                    continue;
+                }
+                wallWords[y * rowWords + (x >> 5)] |= 1u << (x & 31);
+                if (x < width) wallCells[y * width + x] = OBS_WALL;
+            }
+        }
+        blocked.assign((size_t)count * gameWords, 0);
+
+        ringCapacity = 32;
+        while (ringCapacity < freeCells + 16) ringCapacity *= 2; // Body plus segments that start off the board
+        ring.assign((size_t)count * (ringCapacity / 32), 0);
+        ringTail.assign(count, 0);
+    }
+
+    int observationSize() const { return width * height; }
+
+    // Starts every game afresh (game i is seeded from the seed sequence of seed) and fills
+    // observations, count * observationSize() bytes that step() then keeps up to date
+    void reset(uint64_t seed, uint8_t* obs) {
+        observations = obs;
+        Rng seeds(seed);
+        for (int i = 0; i < count; i++) {
+            rng[i].reseed(seeds.next64());
+            resetGame(i);
+        }
+    }
+
+    // Advances every game by one tick. actions[i] is game i's ACTION_*; rewards and dones
+    // receive the outcome of the tick. Games that were done are restarted first.
+    void step(const int32_t* actions, float* rewards, uint8_t* dones) {
+        for (int i = 0; i < count; i++) {
+            if (done[i]) {
+                rng[i].reseed(rng[i].next64());
+                resetGame(i);
+            }
+        }
+        int i = 0;
+#ifdef __AVX2__
+        for (; i + 8 <= count; i += 8) decide8(i, actions);
+#endif
+        for (; i < count; i++) decide1(i, actions);
+        for (i = 0; i < count; i++) apply(i, rewards[i]);
+        for (i = 0; i < count; i++) dones[i] = done[i];
+    }
+
+private:
+    // Result of the decision pass for each game
+    enum { MOVE_OK = 0, MOVE_DIED = 1, MOVE_ATE = 2 };
+
+    int rowWords, gameWords;             // 32-bit occupancy words per row and per game
+    int freeCells;                       // Cells of the level that are not wall
+    std::vector<uint32_t> wallWords;     // Occupancy template: walls and padding
+    std::vector<uint8_t> wallCells;      // Observation template: walls
+    std::vector<uint32_t> blocked;       // Walls and snake cells of every game
+    int ringCapacity;                    // Body steps per game (power of two)
+    std::vector<uint64_t> ring;          // 2-bit ACTION_* steps from the tail to the head, per game
+    std::vector<int64_t> ringTail;       // Ring position of the tail's step
+    std::vector<int32_t> nextX, nextY;   // Head cell after this tick (decision pass)
+    std::vector<int32_t> outcome;        // MOVE_* of this tick (decision pass)
+    uint8_t* observations;               // Caller's buffer
+
+    static constexpr int DX[4] = {0, 0, -1, 1};
+    static constexpr int DY[4] = {-1, 1, 0, 0};
+
+    bool isBlocked(int i, int x, int y) const {
+        return (blocked[(size_t)i * gameWords + y * rowWords + (x >> 5)] >> (x & 31)) & 1;
+    }
+    void setBlocked(int i, int x, int y, bool on) {
+        uint32_t& w = blocked[(size_t)i * gameWords + y * rowWords + (x >> 5)];
+        if (on) w |= 1u << (x & 31);
+        else w &= ~(1u << (x & 31));
+    }
+    bool onBoard(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    uint8_t* observation(int i) { return observations + (size_t)i * width * height; }
+
+    int stepAt(int i, int64_t k) const {
+        uint64_t pos = (uint64_t)k & (uint64_t)(ringCapacity - 1);
+        return (int)((ring[(size_t)i * (ringCapacity / 32) + (pos >> 5)] >> (2 * (pos & 31))) & 3);
+    }
+    void setStep(int i, int64_t k, int code) {
+        uint64_t pos = (uint64_t)k & (uint64_t)(ringCapacity - 1);
+        uint64_t& w = ring[(size_t)i * (ringCapacity / 32) + (pos >> 5)];
+        int shift = 2 * (int)(pos & 31);
+        w = (w & ~(3ULL << shift)) | ((uint64_t)code << shift);
+    }
+
+    // Same start as Board: the middle of the board (near the top-left corner from level 4),
+    // heading right, 3 + (level - 1) segments long
+    void resetGame(int i) {
+        int startX = level >= 4 ? 3 : width / 2, startY = level >= 4 ? 3 : height / 2;
+        length[i] = 3 + (level - 1);
+        headX[i] = startX;
+        headY[i] = startY;
+        tailX[i] = startX - (length[i] - 1);
+        tailY[i] = startY;
+        direction[i] = ACTION_RIGHT;
+        pendingGrowth[i] = 0;
+        score[i] = fruitCount[i] = ticks[i] = 0;
+        done[i] = 0;
+        ringTail[i] = 0;
+        for (int k = 0; k < length[i] - 1; k++) setStep(i, k, ACTION_RIGHT);
+
+        memcpy(&blocked[(size_t)i * gameWords], wallWords.data(), gameWords * sizeof(uint32_t));
+        uint8_t* obs = observation(i);
+        memcpy(obs, wallCells.data(), wallCells.size());
+        for (int x = tailX[i]; x <= startX; x++) { // Segments off the board or in a wall stay off, as in Snake::place
+            if (!onBoard(x, startY) || isBlocked(i, x, startY)) continue;
+            setBlocked(i, x, startY, true);
+            obs[startY * width + x] = x == startX ? OBS_HEAD : OBS_BODY;
+        }
+        spawnFood(i);
+    }
+
+    // Picks a free cell uniformly; returns false if there is none
+    bool spawnFood(int i) {
+        const uint32_t* w = &blocked[(size_t)i * gameWords];
+        int free = 0;
+        for (int k = 0; k < gameWords; k++) free += 32 - __builtin_popcount(w[k]);
+        if (free == 0) {
+            foodX[i] = foodY[i] = -1;
+            return false;
+        }
+        uint32_t r = rng[i].below((uint32_t)free);
+        for (int k = 0; k < gameWords; k++) {
+            uint32_t open = ~w[k];
+            uint32_t n = (uint32_t)__builtin_popcount(open);
+            if (r >= n) {
+                r -= n;
+                continue;
+            }
+            while (r--) open &= open - 1; // Drop the lowest open cells until the r-th is lowest
+            int x = (k % rowWords) * 32 + __builtin_ctz(open), y = k / rowWords;
+            foodX[i] = x;
+            foodY[i] = y;
+            observation(i)[y * width + x] = OBS_FOOD;
+            return true;
+        }
+        return false;
+    }
+
+    // Decision pass for game i: turn, next head, collision and food check (writes nextX/nextY,
+    // outcome and direction)
+    void decide1(int i, const int32_t* actions) {
+        int d = direction[i], a = actions[i];
+        if ((unsigned)a < 4 && a != (d ^ 1)) d = a; // Opposite directions differ in bit 0
+        int nx = headX[i] + DX[d], ny = headY[i] + DY[d];
+        bool hit = !onBoard(nx, ny) ||
+                   (isBlocked(i, nx, ny) && !(pendingGrowth[i] == 0 && nx == tailX[i] && ny == tailY[i]));
+        direction[i] = d;
+        nextX[i] = nx;
+        nextY[i] = ny;
+        outcome[i] = hit ? MOVE_DIED : (nx == foodX[i] && ny == foodY[i]) ? MOVE_ATE : MOVE_OK;
+    }
+
+#ifdef __AVX2__
+    // decide1() for games i .. i + 7
+    void decide8(int i, const int32_t* actions) {
+        const __m256i one = _mm256_set1_epi32(1), zero = _mm256_setzero_si256();
+        __m256i d = _mm256_loadu_si256((const __m256i*)&direction[i]);
+        __m256i a = _mm256_loadu_si256((const __m256i*)&actions[i]);
+        // Valid action: 0 <= a < 4 (unsigned) and not the reverse of d
+        __m256i inRange = _mm256_cmpeq_epi32(_mm256_and_si256(a, _mm256_set1_epi32(~3)), zero);
+        __m256i reverse = _mm256_cmpeq_epi32(a, _mm256_xor_si256(d, one));
+        d = _mm256_blendv_epi8(d, a, _mm256_andnot_si256(reverse, inRange));
+
+        const __m256i dxTable = _mm256_setr_epi32(0, 0, -1, 1, 0, 0, 0, 0);
+        const __m256i dyTable = _mm256_setr_epi32(-1, 1, 0, 0, 0, 0, 0, 0);
+        __m256i nx = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)&headX[i]), _mm256_permutevar8x32_epi32(dxTable, d));
+        __m256i ny = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)&headY[i]), _mm256_permutevar8x32_epi32(dyTable, d));
+
+        // Off the board: x < 0 or x > width - 1, same for y
+        __m256i off = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero, nx), _mm256_cmpgt_epi32(nx, _mm256_set1_epi32(width - 1))),
+            _mm256_or_si256(_mm256_cmpgt_epi32(zero, ny), _mm256_cmpgt_epi32(ny, _mm256_set1_epi32(height - 1))));
+
+        // Occupancy bit of the next head (clamped onto the board so the gather stays in bounds)
+        __m256i cx = _mm256_max_epi32(zero, _mm256_min_epi32(nx, _mm256_set1_epi32(width - 1)));
+        __m256i cy = _mm256_max_epi32(zero, _mm256_min_epi32(ny, _mm256_set1_epi32(height - 1)));
+        __m256i game = _mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i word = _mm256_add_epi32(_mm256_mullo_epi32(game, _mm256_set1_epi32(gameWords)),
+                                        _mm256_add_epi32(_mm256_mullo_epi32(cy, _mm256_set1_epi32(rowWords)),
+                                                         _mm256_srli_epi32(cx, 5)));
+        __m256i bits = _mm256_i32gather_epi32((const int*)blocked.data(), word, 4);
+        __m256i occupied = _mm256_cmpeq_epi32(
+            _mm256_and_si256(_mm256_srlv_epi32(bits, _mm256_and_si256(cx, _mm256_set1_epi32(31))), one), one);
+
+        // The tail's cell is free if the tail moves this tick
+        __m256i tailMoves = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)&pendingGrowth[i]), zero);
+        __m256i atTail = _mm256_and_si256(_mm256_cmpeq_epi32(nx, _mm256_loadu_si256((const __m256i*)&tailX[i])),
+                                          _mm256_cmpeq_epi32(ny, _mm256_loadu_si256((const __m256i*)&tailY[i])));
+        __m256i hit = _mm256_or_si256(off, _mm256_andnot_si256(_mm256_and_si256(tailMoves, atTail), occupied));
+        __m256i ate = _mm256_and_si256(_mm256_cmpeq_epi32(nx, _mm256_loadu_si256((const __m256i*)&foodX[i])),
+                                       _mm256_cmpeq_epi32(ny, _mm256_loadu_si256((const __m256i*)&foodY[i])));
+
+        __m256i result = _mm256_blendv_epi8(_mm256_and_si256(ate, _mm256_set1_epi32(MOVE_ATE)),
+                                            _mm256_set1_epi32(MOVE_DIED), hit);
+        _mm256_storeu_si256((__m256i*)&direction[i], d);
+        _mm256_storeu_si256((__m256i*)&nextX[i], nx);
+        _mm256_storeu_si256((__m256i*)&nextY[i], ny);
+        _mm256_storeu_si256((__m256i*)&outcome[i], result);
+    }
+#endif
+
+    // Write pass for game i: moves the body, updates occupancy and observation, places food
+    void apply(int i, float& reward) {
+        reward = 0;
+        ticks[i]++;
+        if (outcome[i] == MOVE_DIED) {
+            done[i] = 1;
+            reward = REWARD_DEATH;
+            return;
+        }
+        uint8_t* obs = observation(i);
+        if (pendingGrowth[i] > 0) {
+            pendingGrowth[i]--;
+        } else { // The tail leaves its cell
+            int tx = tailX[i], ty = tailY[i];
+            if (onBoard(tx, ty) && obs[ty * width + tx] != OBS_WALL) {
+                setBlocked(i, tx, ty, false);
+                obs[ty * width + tx] = OBS_EMPTY;
+            }
+            int code = stepAt(i, ringTail[i]);
+            tailX[i] = tx + DX[code];
+            tailY[i] = ty + DY[code];
+            ringTail[i]++;
+            length[i]--;
+        }
+        setStep(i, ringTail[i] + length[i] - 1, direction[i]);
+        length[i]++;
+        obs[headY[i] * width + headX[i]] = OBS_BODY;
+        headX[i] = nextX[i];
+        headY[i] = nextY[i];
+        setBlocked(i, headX[i], headY[i], true);
+        obs[headY[i] * width + headX[i]] = OBS_HEAD;
+
+        if (outcome[i] == MOVE_ATE) {
+            bool money = (fruitCount[i] + 1) % 5 == 0; // Every 5th fruit is a money fruit
+            score[i] += money ? 3 : 1;
+            reward = money ? 3 * REWARD_FRUIT : REWARD_FRUIT;
+            fruitCount[i]++;
+            pendingGrowth[i]++;
+            if (!spawnFood(i) || fruitCount[i] >= config.fruitsToClearLevel) done[i] = 1; // Level cleared
+        }
+    }
+};
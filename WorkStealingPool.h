@@ -0,0 +1,150 @@
+// WorkStealingPool.h
+// Fixed-size thread pool for running many independent jobs (batch simulations) on every core.
+// Each worker has its own deque: it takes work from the back of its own deque and, when that
+// is empty, steals from the front of another worker's. Jobs of very different lengths (a
+// game that dies at once next to one that clears six levels) therefore keep all cores busy.
+// Each deque has its own mutex; jobs are whole games, so contention on them is negligible.
+// Idle workers sleep on a condition variable until a job is queued or the pool stops; the
+// queued count is raised under the same lock they wait on, so no wakeup can be missed.
+#pragma once
+
+#include <atomic>             // For the job counters and the stop flag
+#include <condition_variable> // For idle workers and wait()
+#include <deque>              // For the per-worker job deques
+#include <functional>         // For std::function
+#include <memory>             // For std::unique_ptr
+#include <mutex>              // For the deque locks
+#include <thread>             // For the worker threads
+#include <vector>             // For the workers
+
+class WorkStealingPool {
+public:
+    typedef std::function<void(int)> Task; // A job; receives the index of the worker running it
+
+    // Per-worker counters, readable once wait() has returned
+    struct WorkerStats {
+        long long executed = 0; // Jobs run by this worker
+        long long stolen = 0;   // Of those, jobs taken from another worker's deque
+    };
+
+    // Starts threads workers (at least one)
+    explicit WorkStealingPool(int threads) : pending(0), queued(0), stopping(false), nextQueue(0) {
+        if (threads < 1) threads = 1;
+        for (int i = 0; i < threads; i++) workers.emplace_back(new Worker());
+        for (int i = 0; i < threads; i++) pool.emplace_back([this, i] { run(i); });
+    }
+
+    // Finishes every submitted job, then stops and joins the workers
+    ~WorkStealingPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(idleLock);
+            stopping = true;
+        }
+        idle.notify_all();
+        for (std::thread& t : pool) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return (int)workers.size(); }
+
+    // Queues a job. A job submitted from inside a worker goes onto that worker's own deque;
+    // other submissions are spread round-robin.
+    void submit(Task task) {
+        int w = currentPool == this ? currentWorker : (int)(nextQueue++ % workers.size());
+        pending++;
+        {
+            std::lock_guard<std::mutex> lock(workers[w]->lock);
+            workers[w]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleLock); // A worker checking queued cannot miss this job
+            queued++;
+        }
+        idle.notify_one();
+    }
+
+    // Blocks until every job submitted so far has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(idleLock);
+        done.wait(lock, [this] { return pending == 0; });
+    }
+
+    WorkerStats stats(int worker) const {
+        WorkerStats s;
+        s.executed = workers[worker]->executed;
+        s.stolen = workers[worker]->stolen;
+        return s;
+    }
+
+private:
+    struct Worker {
+        std::mutex lock;         // Guards tasks
+        std::deque<Task> tasks;  // Owner pops the back, thieves take the front
+        long long executed = 0;  // Written by the owning worker only
+        long long stolen = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> pool;
+    std::atomic<long long> pending;   // Jobs submitted but not finished
+    std::atomic<long long> queued;    // Jobs in a deque, not yet taken (raised under idleLock)
+    std::atomic<bool> stopping;       // Set by the destructor once all jobs are done
+    std::atomic<unsigned> nextQueue;  // Round-robin target for outside submissions
+    std::mutex idleLock;              // Pairs with idle and done
+    std::condition_variable idle;     // Wakes workers when jobs arrive
+    std::condition_variable done;     // Wakes wait() when pending drops to zero
+
+    // Identifies the pool and worker the calling thread belongs to
+    static inline thread_local const WorkStealingPool* currentPool = nullptr;
+    static inline thread_local int currentWorker = -1;
+
+    // Takes the newest job from the worker's own deque
+    bool popLocal(int w, Task& task) {
+        std::lock_guard<std::mutex> lock(workers[w]->lock);
+        if (workers[w]->tasks.empty()) return false;
+        task = std::move(workers[w]->tasks.back());
+        workers[w]->tasks.pop_back();
+        return true;
+    }
+
+    // Takes the oldest job of the first other worker that has one
+    bool steal(int w, Task& task) {
+        int n = (int)workers.size();
+        for (int i = 1; i < n; i++) {
+            Worker& victim = *workers[(w + i) % n];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void run(int w) {
+        currentPool = this;
+        currentWorker = w;
+        Task task;
+        while (true) {
+            bool stole = false;
+            if (popLocal(w, task) || (stole = steal(w, task))) {
+                queued--;
+                task(w);
+                task = nullptr;
+                workers[w]->executed++;
+                if (stole) workers[w]->stolen++;
+                if (--pending == 0) {
+                    std::lock_guard<std::mutex> lock(idleLock); // Don't let wait() miss the wakeup
+                    done.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idleLock);
+            idle.wait(lock, [this] { return queued > 0 || stopping; });
+            if (stopping && queued == 0) return;
+        }
+    }
+};